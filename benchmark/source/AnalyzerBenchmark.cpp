@@ -0,0 +1,53 @@
+#include "BenchmarkUtilities.h"
+
+namespace audio_plugin_benchmark {
+
+namespace {
+
+/**
+ * @brief processBlock cost with and without the analyzer FIFOs being fed, args: analyzer attached, block size
+ * The FIFOs are drained after every block like the editor's timer would, so the pushes never hit a full buffer.
+ * Compare the two rows of a block size to get the audio-thread overhead of the analyzer.
+*/
+void processWithAnalyzer(benchmark::State &state)
+{
+  constexpr double sampleRate = 48000.0;
+  const auto attached = state.range(0) != 0;
+  const auto blockSize = static_cast<int>(state.range(1));
+
+  audio_plugin::SimpleEQAudioProcessor processor;
+  setParameter(processor, "LowCut Freq", 80.f);
+  setParameter(processor, "HighCut Freq", 12000.f);
+  setParameter(processor, "Peak Gain", 4.f);
+  setParameter(processor, "LowCut Slope", 1.f);
+  setParameter(processor, "HighCut Slope", 1.f);
+  prepareProcessor(processor, sampleRate, blockSize);
+
+  auto &input = processor.getInputAnalyzerFifo();
+  auto &output = processor.getOutputAnalyzerFifo();
+  input.setEnabled(attached);
+  output.setEnabled(attached);
+
+  juce::AudioBuffer<float> buffer(2, blockSize);
+  fillWithNoise(buffer);
+  juce::MidiBuffer midi;
+
+  for (auto _ : state) {
+    processor.processBlock(buffer, midi);
+    benchmark::DoNotOptimize(buffer.getReadPointer(0));
+    benchmark::ClobberMemory();
+
+    input.discard();
+    output.discard();
+  }
+
+  setTimePerSample(state, blockSize);
+}
+
+} // namespace
+
+BENCHMARK(processWithAnalyzer)
+    ->ArgNames({"attached", "block"})
+    ->ArgsProduct({{0, 1}, {64, 256, 1024}});
+
+} // namespace audio_plugin_benchmark
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <SimpleEQ/PluginProcessor.h>
+#include <benchmark/benchmark.h>
+
+namespace audio_plugin_benchmark {
+
+/**
+ * @brief Set a parameter from its real-world value, e.g. Hz or the index of a choice
+*/
+inline void setParameter(audio_plugin::SimpleEQAudioProcessor &processor, const juce::String &parameterID, float value)
+{
+  auto *parameter = processor.apvts.getParameter(parameterID);
+  parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+/**
+ * @brief Prepare the processor the way a host does before the first processBlock call
+*/
+inline void prepareProcessor(audio_plugin::SimpleEQAudioProcessor &processor, double sampleRate, int blockSize)
+{
+  processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+  processor.prepareToPlay(sampleRate, blockSize);
+}
+
+/**
+ * @brief Fill every channel of the buffer with reproducible white noise
+*/
+template <typename SampleType>
+inline void fillWithNoise(juce::AudioBuffer<SampleType> &buffer, juce::int64 seed = 1)
+{
+  juce::Random random {seed};
+  for (int ch = 0; ch < buffer.getNumChannels(); ch++) {
+    for (int i = 0; i < buffer.getNumSamples(); i++) {
+      buffer.setSample(ch, i, static_cast<SampleType>(random.nextFloat() * 2.f - 1.f));
+    }
+  }
+}
+
+/**
+ * @brief Report the time per processed sample, in seconds, next to the time per iteration
+*/
+inline void setTimePerSample(benchmark::State &state, juce::int64 samplesPerIteration)
+{
+  state.counters["seconds_per_sample"] = benchmark::Counter(static_cast<double>(state.iterations()) * static_cast<double>(samplesPerIteration), 
+                                                            benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+} // namespace audio_plugin_benchmark
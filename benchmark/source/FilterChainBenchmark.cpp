@@ -0,0 +1,263 @@
+#include "BenchmarkUtilities.h"
+
+namespace audio_plugin_benchmark {
+
+namespace {
+
+audio_plugin::ChainSettings makeSettings(juce::int64 lowCutSlope, juce::int64 highCutSlope)
+{
+  audio_plugin::ChainSettings settings;
+  settings.lowCutFreq = 80.f;
+  settings.highCutFreq = 12000.f;
+  settings.peakFreq = 1500.f;
+  settings.peakGainInDecibels = 4.f;
+  settings.peakQuality = 1.5f;
+  settings.lowCutSlope = static_cast<audio_plugin::Slope>(lowCutSlope);
+  settings.highCutSlope = static_cast<audio_plugin::Slope>(highCutSlope);
+  return settings;
+}
+
+/**
+ * @brief Steady-state processBlock cost, args: sample rate, block size, low cut slope, high cut slope
+*/
+void processBlock(benchmark::State &state)
+{
+  const auto sampleRate = static_cast<double>(state.range(0));
+  const auto blockSize = static_cast<int>(state.range(1));
+
+  audio_plugin::SimpleEQAudioProcessor processor;
+  setParameter(processor, "LowCut Freq", 80.f);
+  setParameter(processor, "HighCut Freq", 12000.f);
+  setParameter(processor, "Peak Gain", 4.f);
+  setParameter(processor, "LowCut Slope", static_cast<float>(state.range(2)));
+  setParameter(processor, "HighCut Slope", static_cast<float>(state.range(3)));
+  prepareProcessor(processor, sampleRate, blockSize);
+
+  // every block starts from the same noise, refiltering the output would drift towards denormals or inf
+  juce::AudioBuffer<float> input(2, blockSize);
+  fillWithNoise(input);
+
+  juce::AudioBuffer<float> buffer(2, blockSize);
+  juce::MidiBuffer midi;
+
+  for (auto _ : state) {
+    buffer.makeCopyOf(input, true);
+    processor.processBlock(buffer, midi);
+    benchmark::DoNotOptimize(buffer.getReadPointer(0));
+    benchmark::ClobberMemory();
+  }
+
+  setTimePerSample(state, blockSize);
+}
+
+/**
+ * @brief A mono chain with and without pipelining across its sections, args: pipelined, slope of both cuts
+*/
+void processMonoChain(benchmark::State &state)
+{
+  constexpr double sampleRate = 48000.0;
+  constexpr int blockSize = 512;
+  const auto settings = makeSettings(state.range(1), state.range(1));
+
+  audio_plugin::MultiChannelChain chain;
+  chain.prepare({sampleRate, blockSize, 1});
+  chain.setPipelining(state.range(0) != 0);
+
+  auto peak = audio_plugin::designPeakFilter(settings, sampleRate);
+  auto lowCut = audio_plugin::designLowCutFilter(settings, sampleRate);
+  auto highCut = audio_plugin::designHighCutFilter(settings, sampleRate);
+  chain.setStage(audio_plugin::Peak, &peak, 1);
+  chain.setStage(audio_plugin::LowCut, lowCut.data(), audio_plugin::getNumSections(settings.lowCutSlope));
+  chain.setStage(audio_plugin::HighCut, highCut.data(), audio_plugin::getNumSections(settings.highCutSlope));
+
+  juce::AudioBuffer<float> input(1, blockSize);
+  fillWithNoise(input);
+
+  juce::AudioBuffer<float> buffer(1, blockSize);
+  juce::dsp::AudioBlock<float> block(buffer);
+
+  for (auto _ : state) {
+    buffer.makeCopyOf(input, true);
+    chain.process(juce::dsp::ProcessContextReplacing<float>(block));
+    benchmark::DoNotOptimize(buffer.getReadPointer(0));
+    benchmark::ClobberMemory();
+  }
+
+  setTimePerSample(state, blockSize);
+}
+
+/**
+ * @brief processBlock cost of an idle instance whose input has been silent for longer than the tail, args: block size
+*/
+void processSilence(benchmark::State &state)
+{
+  const auto blockSize = static_cast<int>(state.range(0));
+
+  audio_plugin::SimpleEQAudioProcessor processor;
+  setParameter(processor, "LowCut Slope", 3.f);
+  setParameter(processor, "HighCut Slope", 3.f);
+  prepareProcessor(processor, 48000.0, blockSize);
+
+  juce::AudioBuffer<float> buffer(2, blockSize);
+  buffer.clear();
+  juce::MidiBuffer midi;
+
+  // run through the tail before measuring
+  const auto tailBlocks = static_cast<int>(std::ceil(processor.getTailLengthSeconds() * 48000.0 / blockSize)) + 1;
+  for (int i = 0; i < tailBlocks; i++) {
+    processor.processBlock(buffer, midi);
+  }
+
+  for (auto _ : state) {
+    processor.processBlock(buffer, midi);
+    benchmark::DoNotOptimize(buffer.getReadPointer(0));
+    benchmark::ClobberMemory();
+  }
+
+  setTimePerSample(state, blockSize);
+}
+
+/**
+ * @brief Cost of updateFilters when no parameter moved, the common case on the audio thread
+*/
+void updateFiltersUnchanged(benchmark::State &state)
+{
+  audio_plugin::SimpleEQAudioProcessor processor;
+  prepareProcessor(processor, 48000.0, 512);
+
+  for (auto _ : state) {
+    processor.updateFilters();
+  }
+}
+
+/**
+ * @brief Cost of updateFilters when one stage has to be redesigned, args: stage, slope
+*/
+void updateFiltersChanged(benchmark::State &state)
+{
+  const auto stage = static_cast<audio_plugin::ChainPositions>(state.range(0));
+
+  audio_plugin::SimpleEQAudioProcessor processor;
+  setParameter(processor, "LowCut Slope", static_cast<float>(state.range(1)));
+  setParameter(processor, "HighCut Slope", static_cast<float>(state.range(1)));
+  prepareProcessor(processor, 48000.0, 512);
+
+  const char *parameterID = stage == audio_plugin::LowCut ? "LowCut Freq" 
+                          : stage == audio_plugin::Peak ? "Peak Freq" 
+                          : "HighCut Freq";
+
+  // the filters read the published snapshot, so the change has to reach the parameter listeners like host automation
+  auto *frequency = processor.apvts.getParameter(parameterID);
+  const auto initial = frequency->getValue();
+  const auto changed = frequency->convertTo0to1(frequency->convertFrom0to1(initial) * 1.5f);
+  bool toggle = false;
+
+  for (auto _ : state) {
+    toggle = !toggle;
+    frequency->setValueNotifyingHost(toggle ? changed : initial);
+    processor.updateFilters();
+  }
+}
+
+/**
+ * @brief JUCE based designs that allocate their coefficients, args: slope
+*/
+void makeLowCutFilter(benchmark::State &state)
+{
+  const auto settings = makeSettings(state.range(0), 0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(audio_plugin::makeLowCutFilter(settings, 48000.0));
+  }
+}
+
+void makeHighCutFilter(benchmark::State &state)
+{
+  const auto settings = makeSettings(0, state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(audio_plugin::makeHighCutFilter(settings, 48000.0));
+  }
+}
+
+void makePeakFilter(benchmark::State &state)
+{
+  const auto settings = makeSettings(0, 0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(audio_plugin::makePeakFilter(settings, 48000.0));
+  }
+}
+
+/**
+ * @brief Allocation free designs used on the audio thread, args: slope
+*/
+void designLowCutFilter(benchmark::State &state)
+{
+  const auto settings = makeSettings(state.range(0), 0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(audio_plugin::designLowCutFilter(settings, 48000.0));
+  }
+}
+
+void designHighCutFilter(benchmark::State &state)
+{
+  const auto settings = makeSettings(0, state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(audio_plugin::designHighCutFilter(settings, 48000.0));
+  }
+}
+
+void designPeakFilter(benchmark::State &state)
+{
+  const auto settings = makeSettings(0, 0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(audio_plugin::designPeakFilter(settings, 48000.0));
+  }
+}
+
+/**
+ * @brief Lookup of a design another instance already stored in the shared cache, compare with designLowCutFilter
+*/
+void lookupCachedLowCut(benchmark::State &state)
+{
+  const auto settings = makeSettings(3, 0);
+  auto cache = std::make_unique<audio_plugin::CoefficientCache>();
+  const audio_plugin::CoefficientCache::Key key {1, 3, settings.lowCutFreq, 0.f, 0.f, 48000.0};
+  cache->insert(key, audio_plugin::designLowCutFilter<double>(settings, 48000.0));
+
+  audio_plugin::CoefficientCache::Sections sections;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cache->lookup(key, sections));
+    benchmark::DoNotOptimize(sections);
+  }
+}
+
+} // namespace
+
+BENCHMARK(processBlock)
+    ->ArgNames({"rate", "block", "lowSlope", "highSlope"})
+    ->ArgsProduct({{44100, 48000, 96000, 192000}, 
+                   benchmark::CreateRange(1, 4096, 8), 
+                   benchmark::CreateDenseRange(0, 3, 1), 
+                   benchmark::CreateDenseRange(0, 3, 1)});
+
+BENCHMARK(processMonoChain)
+    ->ArgNames({"pipelined", "slope"})
+    ->ArgsProduct({{0, 1}, benchmark::CreateDenseRange(0, 3, 1)});
+
+BENCHMARK(processSilence)->ArgName("block")->RangeMultiplier(4)->Range(64, 4096);
+
+BENCHMARK(updateFiltersUnchanged);
+BENCHMARK(updateFiltersChanged)
+    ->ArgNames({"stage", "slope"})
+    ->ArgsProduct({benchmark::CreateDenseRange(0, 2, 1), benchmark::CreateDenseRange(0, 3, 1)});
+
+BENCHMARK(makeLowCutFilter)->ArgName("slope")->DenseRange(0, 3);
+BENCHMARK(makeHighCutFilter)->ArgName("slope")->DenseRange(0, 3);
+BENCHMARK(makePeakFilter);
+
+BENCHMARK(designLowCutFilter)->ArgName("slope")->DenseRange(0, 3);
+BENCHMARK(designHighCutFilter)->ArgName("slope")->DenseRange(0, 3);
+BENCHMARK(designPeakFilter);
+
+BENCHMARK(lookupCachedLowCut);
+
+} // namespace audio_plugin_benchmark
@@ -0,0 +1,178 @@
+#include "BenchmarkUtilities.h"
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace audio_plugin_benchmark {
+
+namespace {
+
+/**
+ * @brief Instances processed by one host worker thread and the processBlock latencies it observed
+ * Latencies go into a preallocated ring, so recording them doesn't touch the allocator the instances compete for.
+ * Workers sit next to each other in a vector, the alignment keeps the counters every block writes on a cache
+ * line of their own, so the threads don't contend for it and show that as instance latency.
+*/
+struct alignas(64) Worker {
+  static constexpr size_t maxLatencies = 1 << 16;
+
+  std::vector<audio_plugin::SimpleEQAudioProcessor *> instances;
+  std::vector<juce::AudioBuffer<float>> buffers;
+
+  // the parameters that feed the filters, the mode switches would change the work per block
+  std::vector<std::vector<juce::AudioProcessorParameter *>> automated;
+  std::vector<double> latencies = std::vector<double>(maxLatencies);
+
+  // written on every block, the line they start is padded to the end of the worker by the alignment
+  alignas(64) size_t numLatencies {0};
+  juce::Random random;
+
+  void record(double seconds) noexcept
+  {
+    latencies[numLatencies % maxLatencies] = seconds;
+    numLatencies++;
+  }
+
+  /**
+   * @brief One host cycle, every instance of the worker processes one block
+  */
+  void process(int blockSize, juce::MidiBuffer &midi)
+  {
+    for (size_t i = 0; i < instances.size(); i++) {
+      auto &processor = *instances[i];
+      auto &buffer = buffers[i];
+
+      // sparse automation, like a host's automation lanes on a few of the instances
+      if (random.nextInt(8) == 0) {
+        const auto &parameters = automated[i];
+        parameters[static_cast<size_t>(random.nextInt(static_cast<int>(parameters.size())))]->setValueNotifyingHost(random.nextFloat());
+      }
+
+      for (int ch = 0; ch < buffer.getNumChannels(); ch++) {
+        auto *samples = buffer.getWritePointer(ch);
+        for (int n = 0; n < blockSize; n++) {
+          samples[n] = random.nextFloat() * 0.5f - 0.25f;
+        }
+      }
+
+      const auto start = std::chrono::steady_clock::now();
+      processor.processBlock(buffer, midi);
+      const auto end = std::chrono::steady_clock::now();
+
+      record(std::chrono::duration<double>(end - start).count());
+      benchmark::DoNotOptimize(buffer.getReadPointer(0));
+    }
+  }
+};
+
+double getPercentile(std::vector<double> &values, double percentile)
+{
+  if (values.empty()) {
+    return 0.0;
+  }
+
+  const auto index = static_cast<size_t>(percentile * static_cast<double>(values.size() - 1));
+  std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+  return values[index];
+}
+
+/**
+ * @brief Many instances driven by a pool of host worker threads, args: instances, threads, block size
+ *
+ * Every iteration is one host cycle: the instances are spread round robin over the workers, each worker
+ * processes its instances one block each, and the cycle ends when the slowest worker is done. The counters
+ * report the processBlock latency percentiles over all calls, in seconds, and the samples per second of all
+ * instances together. Contention between instances shows as latencies that grow with the thread count
+ * while the work per instance stays the same.
+*/
+void processManyInstances(benchmark::State &state)
+{
+  constexpr double sampleRate = 48000.0;
+  const auto numInstances = static_cast<size_t>(state.range(0));
+  const auto numThreads = static_cast<size_t>(state.range(1));
+  const auto blockSize = static_cast<int>(state.range(2));
+
+  std::vector<std::unique_ptr<audio_plugin::SimpleEQAudioProcessor>> instances;
+  std::vector<Worker> workers(numThreads);
+
+  for (size_t i = 0; i < numInstances; i++) {
+    auto &processor = *instances.emplace_back(std::make_unique<audio_plugin::SimpleEQAudioProcessor>());
+    setParameter(processor, "LowCut Slope", 2.f);
+    setParameter(processor, "HighCut Slope", 2.f);
+    setParameter(processor, "Peak Gain", 3.f);
+    prepareProcessor(processor, sampleRate, blockSize);
+
+    auto &worker = workers[i % numThreads];
+    worker.instances.push_back(&processor);
+    worker.buffers.emplace_back(2, blockSize);
+
+    auto &automated = worker.automated.emplace_back();
+    for (auto *parameter : processor.getParameters()) {
+      const auto id = dynamic_cast<juce::RangedAudioParameter *>(parameter)->getParameterID();
+      if (id != "Smoothing" && id != "Oversampling" && id != "Linear Phase") {
+        automated.push_back(parameter);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < numThreads; i++) {
+    workers[i].random.setSeed(static_cast<juce::int64>(i + 1));
+  }
+
+  // the cycle starts and ends on the benchmark thread, like the host's audio callback waiting for its workers
+  std::barrier start(static_cast<std::ptrdiff_t>(numThreads + 1)), finish(static_cast<std::ptrdiff_t>(numThreads + 1));
+  std::atomic<bool> running {true};
+  std::vector<std::thread> threads;
+
+  for (auto &worker : workers) {
+    threads.emplace_back([&, blockSize] {
+      juce::MidiBuffer midi;
+      for (;;) {
+        start.arrive_and_wait();
+        if (!running.load()) {
+          return;
+        }
+        worker.process(blockSize, midi);
+        finish.arrive_and_wait();
+      }
+    });
+  }
+
+  for (auto _ : state) {
+    start.arrive_and_wait();
+    finish.arrive_and_wait();
+  }
+
+  running.store(false);
+  start.arrive_and_wait();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::vector<double> latencies;
+  for (const auto &worker : workers) {
+    const auto count = std::min(worker.numLatencies, Worker::maxLatencies);
+    latencies.insert(latencies.end(), worker.latencies.begin(), worker.latencies.begin() + static_cast<std::ptrdiff_t>(count));
+  }
+
+  state.counters["p50"] = getPercentile(latencies, 0.5);
+  state.counters["p99"] = getPercentile(latencies, 0.99);
+  state.counters["max"] = latencies.empty() ? 0.0 : *std::max_element(latencies.begin(), latencies.end());
+  state.counters["samples_per_second"] = benchmark::Counter(static_cast<double>(state.iterations()) * static_cast<double>(numInstances * static_cast<size_t>(blockSize)),
+                                                            benchmark::Counter::kIsRate);
+}
+
+} // namespace
+
+BENCHMARK(processManyInstances)
+    ->ArgNames({"instances", "threads", "block"})
+    ->ArgsProduct({{1, 16, 64, 256}, {1, 2, 4, 8}, {64, 256}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace audio_plugin_benchmark
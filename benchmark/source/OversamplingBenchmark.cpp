@@ -0,0 +1,46 @@
+#include "BenchmarkUtilities.h"
+
+namespace audio_plugin_benchmark {
+
+namespace {
+
+/**
+ * @brief processBlock cost per oversampling factor, args: oversampling index (log2 of the factor), block size
+ * Uses the steepest cut filters, the worst case for the chain that runs at the oversampled rate.
+*/
+void processOversampled(benchmark::State &state)
+{
+  constexpr double sampleRate = 48000.0;
+  const auto blockSize = static_cast<int>(state.range(1));
+
+  audio_plugin::SimpleEQAudioProcessor processor;
+  setParameter(processor, "Oversampling", static_cast<float>(state.range(0)));
+  setParameter(processor, "LowCut Freq", 80.f);
+  setParameter(processor, "HighCut Freq", 12000.f);
+  setParameter(processor, "Peak Freq", 16000.f);
+  setParameter(processor, "Peak Gain", 6.f);
+  setParameter(processor, "LowCut Slope", 3.f);
+  setParameter(processor, "HighCut Slope", 3.f);
+  prepareProcessor(processor, sampleRate, blockSize);
+
+  juce::AudioBuffer<float> buffer(2, blockSize);
+  fillWithNoise(buffer);
+  juce::MidiBuffer midi;
+
+  for (auto _ : state) {
+    processor.processBlock(buffer, midi);
+    benchmark::DoNotOptimize(buffer.getReadPointer(0));
+    benchmark::ClobberMemory();
+  }
+
+  state.counters["latency"] = processor.getLatencySamples();
+  setTimePerSample(state, blockSize);
+}
+
+} // namespace
+
+BENCHMARK(processOversampled)
+    ->ArgNames({"oversampling", "block"})
+    ->ArgsProduct({benchmark::CreateDenseRange(0, 2, 1), {64, 256, 1024}});
+
+} // namespace audio_plugin_benchmark
@@ -0,0 +1,57 @@
+#include "BenchmarkUtilities.h"
+
+namespace audio_plugin_benchmark {
+
+namespace {
+
+using PrecisionMode = audio_plugin::SimpleEQAudioProcessor::PrecisionMode;
+
+/**
+ * @brief processBlock cost per precision, args: sample rate, precision mode, double buffer (0 or 1)
+ * A 48 dB/Oct low cut at 20 Hz is the stage that Automatic moves to double, the other stages stay in float.
+*/
+template <typename SampleType>
+void runPrecision(benchmark::State &state, PrecisionMode mode)
+{
+  const auto sampleRate = static_cast<double>(state.range(0));
+  constexpr int blockSize = 256;
+
+  audio_plugin::SimpleEQAudioProcessor processor;
+  processor.setPrecisionMode(mode);
+  processor.setProcessingPrecision(std::is_same_v<SampleType, double> ? juce::AudioProcessor::doublePrecision 
+                                                                      : juce::AudioProcessor::singlePrecision);
+  setParameter(processor, "LowCut Freq", 20.f);
+  setParameter(processor, "LowCut Slope", 3.f);
+  setParameter(processor, "Peak Gain", 6.f);
+  prepareProcessor(processor, sampleRate, blockSize);
+
+  juce::AudioBuffer<SampleType> buffer(2, blockSize);
+  fillWithNoise(buffer);
+  juce::MidiBuffer midi;
+
+  for (auto _ : state) {
+    processor.processBlock(buffer, midi);
+    benchmark::DoNotOptimize(buffer.getReadPointer(0));
+    benchmark::ClobberMemory();
+  }
+
+  setTimePerSample(state, blockSize);
+}
+
+void processPrecision(benchmark::State &state)
+{
+  if (state.range(2) != 0) {
+    runPrecision<double>(state, PrecisionMode::Double);
+  } else {
+    runPrecision<float>(state, static_cast<PrecisionMode>(state.range(1)));
+  }
+}
+
+} // namespace
+
+BENCHMARK(processPrecision)
+    ->ArgNames({"rate", "mode", "double"})
+    ->ArgsProduct({{48000, 192000}, benchmark::CreateDenseRange(0, 2, 1), {0}})
+    ->ArgsProduct({{48000, 192000}, {2}, {1}});
+
+} // namespace audio_plugin_benchmark
@@ -0,0 +1,29 @@
+#include "BenchmarkUtilities.h"
+
+namespace audio_plugin_benchmark {
+
+namespace {
+
+/**
+ * @brief What the profiling adds to every processBlock: the block, the filters and a coefficient update
+ * Compare with processBlock at the smallest block sizes, or build with SIMPLEEQ_PROFILING=OFF and compare the whole run.
+*/
+void profileBlock(benchmark::State &state)
+{
+  auto profiler = std::make_unique<audio_plugin::Profiler>();
+
+  for (auto _ : state) {
+    profiler->beginBlock(64);
+    {
+      audio_plugin::Profiler::ScopedSection filters {*profiler, audio_plugin::Profiler::Filters};
+      audio_plugin::Profiler::ScopedSection coefficients {*profiler, audio_plugin::Profiler::Coefficients};
+    }
+    profiler->endBlock();
+  }
+}
+
+} // namespace
+
+BENCHMARK(profileBlock);
+
+} // namespace audio_plugin_benchmark
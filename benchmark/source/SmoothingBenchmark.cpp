@@ -0,0 +1,49 @@
+#include "BenchmarkUtilities.h"
+
+namespace audio_plugin_benchmark {
+
+namespace {
+
+/**
+ * @brief Process noise while Peak Freq and Peak Gain are automated on every block
+ * @param smoothing Whether the smoothing mode or the stepped path is measured
+*/
+void processAutomatedPeak(benchmark::State &state, bool smoothing)
+{
+  constexpr double sampleRate = 48000.0;
+  const auto blockSize = static_cast<int>(state.range(0));
+
+  audio_plugin::SimpleEQAudioProcessor processor;
+  setParameter(processor, "Smoothing", smoothing ? 1.f : 0.f);
+  prepareProcessor(processor, sampleRate, blockSize);
+
+  juce::AudioBuffer<float> input(2, blockSize);
+  fillWithNoise(input);
+
+  juce::AudioBuffer<float> buffer(2, blockSize);
+  juce::MidiBuffer midi;
+
+  auto *peakFreq = processor.apvts.getParameter("Peak Freq");
+  auto *peakGain = processor.apvts.getParameter("Peak Gain");
+  float phase = 0.f;
+
+  for (auto _ : state) {
+    // a fast sweep that keeps the smoothers moving all the time
+    phase += 0.05f;
+    peakFreq->setValueNotifyingHost(0.5f + 0.4f * std::sin(phase));
+    peakGain->setValueNotifyingHost(0.5f + 0.4f * std::cos(phase));
+
+    buffer.makeCopyOf(input, true);
+    processor.processBlock(buffer, midi);
+    benchmark::DoNotOptimize(buffer.getReadPointer(0));
+  }
+
+  setTimePerSample(state, blockSize);
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(processAutomatedPeak, stepped, false)->RangeMultiplier(4)->Range(32, 2048);
+BENCHMARK_CAPTURE(processAutomatedPeak, smoothed, true)->RangeMultiplier(4)->Range(32, 2048);
+
+} // namespace audio_plugin_benchmark
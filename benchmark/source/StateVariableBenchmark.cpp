@@ -0,0 +1,204 @@
+#include "BenchmarkUtilities.h"
+
+namespace audio_plugin_benchmark {
+
+namespace {
+
+using FilterEngine = audio_plugin::SimpleEQAudioProcessor::FilterEngine;
+
+audio_plugin::ChainSettings makeSettings(juce::int64 slope)
+{
+  audio_plugin::ChainSettings settings;
+  settings.lowCutFreq = 80.f;
+  settings.highCutFreq = 12000.f;
+  settings.peakFreq = 1500.f;
+  settings.peakGainInDecibels = 4.f;
+  settings.peakQuality = 1.5f;
+  settings.lowCutSlope = static_cast<audio_plugin::Slope>(slope);
+  settings.highCutSlope = static_cast<audio_plugin::Slope>(slope);
+  return settings;
+}
+
+/**
+ * @brief Both chains with fixed settings, args: channels, slope of both cuts
+*/
+void processSteadyBiquads(benchmark::State &state)
+{
+  constexpr double sampleRate = 48000.0;
+  constexpr int blockSize = 512;
+  const auto numChannels = static_cast<int>(state.range(0));
+  const auto settings = makeSettings(state.range(1));
+
+  audio_plugin::MultiChannelChain chain;
+  chain.prepare({sampleRate, blockSize, static_cast<juce::uint32>(numChannels)});
+
+  auto peak = audio_plugin::designPeakFilter(settings, sampleRate);
+  auto lowCut = audio_plugin::designLowCutFilter(settings, sampleRate);
+  auto highCut = audio_plugin::designHighCutFilter(settings, sampleRate);
+  chain.setStage(audio_plugin::Peak, &peak, 1);
+  chain.setStage(audio_plugin::LowCut, lowCut.data(), audio_plugin::getNumSections(settings.lowCutSlope));
+  chain.setStage(audio_plugin::HighCut, highCut.data(), audio_plugin::getNumSections(settings.highCutSlope));
+
+  juce::AudioBuffer<float> buffer(numChannels, blockSize);
+  fillWithNoise(buffer);
+  juce::dsp::AudioBlock<float> block(buffer);
+
+  for (auto _ : state) {
+    chain.process(juce::dsp::ProcessContextReplacing<float>(block));
+    benchmark::DoNotOptimize(buffer.getReadPointer(0));
+    benchmark::ClobberMemory();
+  }
+
+  setTimePerSample(state, blockSize);
+}
+
+void processSteadyStateVariable(benchmark::State &state)
+{
+  constexpr double sampleRate = 48000.0;
+  constexpr int blockSize = 512;
+  const auto numChannels = static_cast<int>(state.range(0));
+
+  audio_plugin::StateVariableChain chain;
+  chain.prepare({sampleRate, blockSize, static_cast<juce::uint32>(numChannels)});
+  audio_plugin::setStateVariableChain(chain, makeSettings(state.range(1)), sampleRate);
+
+  juce::AudioBuffer<float> buffer(numChannels, blockSize);
+  fillWithNoise(buffer);
+  juce::dsp::AudioBlock<float> block(buffer);
+
+  for (auto _ : state) {
+    chain.process(juce::dsp::ProcessContextReplacing<float>(block));
+    benchmark::DoNotOptimize(buffer.getReadPointer(0));
+    benchmark::ClobberMemory();
+  }
+
+  setTimePerSample(state, blockSize);
+}
+
+/**
+ * @brief Cost of moving all three stages on every sample of the block, args: slope of both cuts
+ * Every iteration starts a new ramp over the whole block, the state variable chain recomputes its sections
+ * per sample, compare with the biquad chain ramping its coefficients between designs every 32 samples.
+*/
+void modulateStateVariable(benchmark::State &state)
+{
+  constexpr double sampleRate = 48000.0;
+  constexpr int blockSize = 512;
+
+  audio_plugin::StateVariableChain chain;
+  chain.prepare({sampleRate, blockSize, 2});
+
+  auto settings = makeSettings(state.range(0));
+  audio_plugin::setStateVariableChain(chain, settings, sampleRate);
+
+  juce::AudioBuffer<float> buffer(2, blockSize);
+  fillWithNoise(buffer);
+  juce::dsp::AudioBlock<float> block(buffer);
+  float phase = 0.f;
+
+  for (auto _ : state) {
+    phase += 0.05f;
+    settings.lowCutFreq = 80.f * (1.5f + std::sin(phase));
+    settings.peakFreq = 1500.f * (1.5f + std::cos(phase));
+    settings.highCutFreq = 8000.f * (1.5f + std::sin(phase));
+    audio_plugin::setStateVariableChain(chain, settings, sampleRate, blockSize);
+
+    chain.process(juce::dsp::ProcessContextReplacing<float>(block));
+    benchmark::DoNotOptimize(buffer.getReadPointer(0));
+    benchmark::ClobberMemory();
+  }
+
+  setTimePerSample(state, blockSize);
+}
+
+void modulateBiquads(benchmark::State &state)
+{
+  constexpr double sampleRate = 48000.0;
+  constexpr int blockSize = 512;
+  constexpr int interval = audio_plugin::ChainSmoother::updateInterval;
+
+  audio_plugin::MultiChannelChain chain;
+  chain.prepare({sampleRate, blockSize, 2});
+
+  auto settings = makeSettings(state.range(0));
+  juce::AudioBuffer<float> buffer(2, blockSize);
+  fillWithNoise(buffer);
+  juce::dsp::AudioBlock<float> block(buffer);
+  float phase = 0.f;
+
+  for (auto _ : state) {
+    for (int start = 0; start < blockSize; start += interval) {
+      phase += 0.05f * interval / blockSize;
+      settings.lowCutFreq = 80.f * (1.5f + std::sin(phase));
+      settings.peakFreq = 1500.f * (1.5f + std::cos(phase));
+      settings.highCutFreq = 8000.f * (1.5f + std::sin(phase));
+
+      auto peak = audio_plugin::designPeakFilter(settings, sampleRate);
+      auto lowCut = audio_plugin::designLowCutFilter(settings, sampleRate);
+      auto highCut = audio_plugin::designHighCutFilter(settings, sampleRate);
+      chain.setStage(audio_plugin::Peak, &peak, 1, interval);
+      chain.setStage(audio_plugin::LowCut, lowCut.data(), audio_plugin::getNumSections(settings.lowCutSlope), interval);
+      chain.setStage(audio_plugin::HighCut, highCut.data(), audio_plugin::getNumSections(settings.highCutSlope), interval);
+
+      auto subBlock = block.getSubBlock(static_cast<size_t>(start), interval);
+      chain.process(juce::dsp::ProcessContextReplacing<float>(subBlock));
+    }
+    benchmark::DoNotOptimize(buffer.getReadPointer(0));
+    benchmark::ClobberMemory();
+  }
+
+  setTimePerSample(state, blockSize);
+}
+
+/**
+ * @brief processBlock in smoothing mode while the peak is automated on every block, args: block size
+*/
+void processAutomatedPeakWithEngine(benchmark::State &state, FilterEngine engine)
+{
+  constexpr double sampleRate = 48000.0;
+  const auto blockSize = static_cast<int>(state.range(0));
+
+  audio_plugin::SimpleEQAudioProcessor processor;
+  processor.setFilterEngine(engine);
+  setParameter(processor, "Smoothing", 1.f);
+  prepareProcessor(processor, sampleRate, blockSize);
+
+  juce::AudioBuffer<float> input(2, blockSize);
+  fillWithNoise(input);
+
+  juce::AudioBuffer<float> buffer(2, blockSize);
+  juce::MidiBuffer midi;
+
+  auto *peakFreq = processor.apvts.getParameter("Peak Freq");
+  auto *peakGain = processor.apvts.getParameter("Peak Gain");
+  float phase = 0.f;
+
+  for (auto _ : state) {
+    phase += 0.05f;
+    peakFreq->setValueNotifyingHost(0.5f + 0.4f * std::sin(phase));
+    peakGain->setValueNotifyingHost(0.5f + 0.4f * std::cos(phase));
+
+    buffer.makeCopyOf(input, true);
+    processor.processBlock(buffer, midi);
+    benchmark::DoNotOptimize(buffer.getReadPointer(0));
+  }
+
+  setTimePerSample(state, blockSize);
+}
+
+} // namespace
+
+BENCHMARK(processSteadyBiquads)
+    ->ArgNames({"channels", "slope"})
+    ->ArgsProduct({{1, 2, 8}, benchmark::CreateDenseRange(0, 3, 1)});
+BENCHMARK(processSteadyStateVariable)
+    ->ArgNames({"channels", "slope"})
+    ->ArgsProduct({{1, 2, 8}, benchmark::CreateDenseRange(0, 3, 1)});
+
+BENCHMARK(modulateBiquads)->ArgName("slope")->DenseRange(0, 3, 1);
+BENCHMARK(modulateStateVariable)->ArgName("slope")->DenseRange(0, 3, 1);
+
+BENCHMARK_CAPTURE(processAutomatedPeakWithEngine, biquad, FilterEngine::Biquad)->RangeMultiplier(4)->Range(32, 2048);
+BENCHMARK_CAPTURE(processAutomatedPeakWithEngine, stateVariable, FilterEngine::StateVariable)->RangeMultiplier(4)->Range(32, 2048);
+
+} // namespace audio_plugin_benchmark
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+#include <atomic>
+#include <type_traits>
+#include <vector>
+
+namespace audio_plugin {
+
+/**
+ * @brief Wait-free single producer, single consumer ring buffer that carries a mono mix of the audio to the analyzer
+ *
+ * The audio thread is the only producer and the analyzer the only consumer. The storage is allocated once
+ * at construction and never resized, so neither side can observe a reallocation. When the consumer falls
+ * behind, the samples that don't fit are dropped instead of waiting, and while no consumer is attached
+ * push() returns after a single atomic load.
+*/
+class AnalyzerFifo {
+public:
+  /**
+   * @brief Number of samples the buffer holds, about a third of a second at 96 kHz
+  */
+  static constexpr int capacity = 1 << 15;
+
+  AnalyzerFifo() : storage(static_cast<size_t>(capacity + 1)) {}
+
+  /**
+   * @brief Attach or detach the consumer, the audio thread only pushes while a consumer is attached
+  */
+  void setEnabled(bool shouldBeEnabled) noexcept
+  {
+    enabled.store(shouldBeEnabled, std::memory_order_release);
+  }
+
+  bool isEnabled() const noexcept { return enabled.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Mix the channels of the block down to mono and append them, called on the audio thread
+  */
+  template <typename SampleType>
+  void push(const juce::dsp::AudioBlock<SampleType> &block) noexcept
+  {
+    if (!isEnabled() || block.getNumChannels() == 0) {
+      return;
+    }
+
+    const auto numChannels = block.getNumChannels();
+    const auto numSamples = juce::jmin(static_cast<int>(block.getNumSamples()), fifo.getFreeSpace());
+    const auto gain = 1.f / static_cast<float>(numChannels);
+
+    // the write is committed when it goes out of scope, after both parts were filled
+    const auto write = fifo.write(numSamples);
+
+    auto mix = [&](int destination, int source, int count) {
+      if (count <= 0) {
+        return;
+      }
+
+      auto *out = storage.data() + destination;
+
+      if constexpr (std::is_same_v<SampleType, float>) {
+        juce::FloatVectorOperations::copyWithMultiply(out, block.getChannelPointer(0) + source, gain, count);
+        for (size_t ch = 1; ch < numChannels; ch++) {
+          juce::FloatVectorOperations::addWithMultiply(out, block.getChannelPointer(ch) + source, gain, count);
+        }
+      } else {
+        // the analyzer doesn't need more than single precision
+        for (int i = 0; i < count; i++) {
+          SampleType sum {0};
+          for (size_t ch = 0; ch < numChannels; ch++) {
+            sum += block.getChannelPointer(ch)[source + i];
+          }
+          out[i] = static_cast<float>(sum) * gain;
+        }
+      }
+    };
+
+    mix(write.startIndex1, 0, write.blockSize1);
+    mix(write.startIndex2, write.blockSize1, write.blockSize2);
+  }
+
+  /**
+   * @brief Move up to maxSamples into destination, called by the consumer
+   * @return The number of samples read
+  */
+  int pull(float *destination, int maxSamples) noexcept
+  {
+    const auto read = fifo.read(juce::jmin(maxSamples, fifo.getNumReady()));
+
+    if (read.blockSize1 > 0) {
+      juce::FloatVectorOperations::copy(destination, storage.data() + read.startIndex1, read.blockSize1);
+    }
+    if (read.blockSize2 > 0) {
+      juce::FloatVectorOperations::copy(destination + read.blockSize1, storage.data() + read.startIndex2, read.blockSize2);
+    }
+
+    return read.blockSize1 + read.blockSize2;
+  }
+
+  /**
+   * @brief Drop everything that was pushed so far, only call this from the consumer
+  */
+  void discard() noexcept
+  {
+    const auto read = fifo.read(fifo.getNumReady());
+    juce::ignoreUnused(read);
+  }
+
+  int getNumReady() const noexcept { return fifo.getNumReady(); }
+
+private:
+  // AbstractFifo keeps one slot free to tell a full buffer from an empty one
+  juce::AbstractFifo fifo {capacity + 1};
+  std::vector<float> storage;
+  std::atomic<bool> enabled {false};
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalyzerFifo)
+};
+
+} // namespace audio_plugin
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+namespace audio_plugin {
+
+/**
+ * @brief Number of bands with their own dedicated parameters, LowCut, Peak and HighCut
+*/
+constexpr size_t numFixedBands = 3;
+
+/**
+ * @brief Number of bands the chain can hold, the fixed bands come first
+*/
+constexpr size_t maxBands = 16;
+
+/**
+ * @brief Number of freely configurable bands after the fixed ones
+*/
+constexpr size_t numExtraBands = maxBands - numFixedBands;
+
+/**
+ * @brief Position of an extra band in the chain
+*/
+constexpr size_t getBandPosition(size_t extraBand)
+{
+  return numFixedBands + extraBand;
+}
+
+} // namespace audio_plugin
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include <array>
+#include <type_traits>
+
+#if JUCE_USE_SIMD && JUCE_INTEL
+ #include <immintrin.h>
+#elif JUCE_USE_SIMD && JUCE_ARM
+ #include <arm_neon.h>
+#endif
+
+namespace audio_plugin {
+
+/**
+ * @brief Vector type holding one sample of several channels, falls back to a scalar without SIMD support
+*/
+#if JUCE_USE_SIMD
+template <typename SampleType>
+using SIMDVector = juce::dsp::SIMDRegister<SampleType>;
+#else
+template <typename SampleType>
+using SIMDVector = SampleType;
+#endif
+
+/**
+ * @brief Number of channels that are processed together in one vector
+*/
+template <typename SampleType>
+constexpr size_t numLanes()
+{
+  if constexpr (std::is_same_v<SIMDVector<SampleType>, SampleType>) {
+    return 1;
+  } else {
+    return SIMDVector<SampleType>::size();
+  }
+}
+
+/**
+ * @brief Normalised coefficients of a second order section
+*/
+template <typename SampleType>
+struct BiquadCoefficients {
+  SampleType b0 {1}, b1 {0}, b2 {0}, a1 {0}, a2 {0};
+
+  /**
+   * @brief Normalise raw {b0, b1, b2, a0, a1, a2} coefficients exactly like juce::dsp::IIR::Coefficients does
+  */
+  static BiquadCoefficients fromRaw(const std::array<SampleType, 6> &raw) noexcept
+  {
+    // numerator and denominator cancel, e.g. a peak or shelf at 0 dB, normalising could leave b0 an ulp off one
+    if (raw[0] == raw[3] && raw[1] == raw[4] && raw[2] == raw[5]) {
+      return {};
+    }
+
+    const auto a0 = raw[3];
+    const auto a0Inv = a0 != SampleType(0) ? static_cast<SampleType>(1) / a0 : SampleType(0);
+
+    return {raw[0] * a0Inv, raw[1] * a0Inv, raw[2] * a0Inv, raw[4] * a0Inv, raw[5] * a0Inv};
+  }
+
+  /**
+   * @brief True if the section passes its input through unchanged, e.g. a peak or shelf at 0 dB
+  */
+  bool isIdentity() const noexcept
+  {
+    return b0 == SampleType(1) && b1 == SampleType(0) && b2 == SampleType(0) && a1 == SampleType(0) && a2 == SampleType(0);
+  }
+};
+
+/**
+ * @brief Radius of the pole closest to the unit circle, the closer to one the slower the section decays
+ * and the more its response suffers from rounding in single precision
+*/
+template <typename SampleType>
+inline double getPoleRadius(const BiquadCoefficients<SampleType> &c) noexcept
+{
+  // the poles are the roots of z^2 + a1 z + a2
+  const auto a1 = static_cast<double>(c.a1);
+  const auto a2 = static_cast<double>(c.a2);
+  const auto discriminant = a1 * a1 - 4.0 * a2;
+
+  if (discriminant < 0.0) {
+    return std::sqrt(a2);
+  }
+
+  const auto root = std::sqrt(discriminant);
+  return juce::jmax(std::abs(-a1 + root), std::abs(-a1 - root)) / 2.0;
+}
+
+/**
+ * @brief Per-sample increment that moves the coefficients from one set to another in numSteps steps
+ * The stability region of (a1, a2) is convex, so every step between two stable sections is stable as well.
+*/
+template <typename SampleType>
+inline BiquadCoefficients<SampleType> getCoefficientIncrement(const BiquadCoefficients<SampleType> &from, 
+                                                              const BiquadCoefficients<SampleType> &to, 
+                                                              size_t numSteps) noexcept
+{
+  const auto scale = static_cast<SampleType>(1) / static_cast<SampleType>(numSteps);
+  return {(to.b0 - from.b0) * scale, (to.b1 - from.b1) * scale, (to.b2 - from.b2) * scale, 
+          (to.a1 - from.a1) * scale, (to.a2 - from.a2) * scale};
+}
+
+template <typename SampleType>
+inline void advanceCoefficients(BiquadCoefficients<SampleType> &c, const BiquadCoefficients<SampleType> &increment) noexcept
+{
+  c.b0 += increment.b0;
+  c.b1 += increment.b1;
+  c.b2 += increment.b2;
+  c.a1 += increment.a1;
+  c.a2 += increment.a2;
+}
+
+/**
+ * @brief State of a second order section, one lane per channel
+*/
+template <typename VectorType>
+struct BiquadState {
+  VectorType s1 {}, s2 {};
+};
+
+/**
+ * @brief Process one sample through a section in transposed direct form II
+ * The operations are ordered like juce::dsp::IIR::Filter, so every lane is bit-exact with the scalar filter.
+ * The coefficients are either scalars shared by every lane or vectors with a section per lane.
+*/
+template <typename VectorType, typename CoefficientsType>
+inline VectorType processBiquad(const CoefficientsType &c, BiquadState<VectorType> &s, VectorType input) noexcept
+{
+  auto output = (input * c.b0) + s.s1;
+  s.s1 = (input * c.b1) - (output * c.a1) + s.s2;
+  s.s2 = (input * c.b2) - (output * c.a2);
+  return output;
+}
+
+/**
+ * @brief Move every lane up by one and put the sample into lane 0, e.g. {a, b, c, d} becomes {x, a, b, c}
+ * A single shuffle on SSE, AVX2 and NEON, other targets go through memory.
+*/
+template <typename SampleType>
+inline SIMDVector<SampleType> shiftLanesUp(const SIMDVector<SampleType> &v, SampleType x) noexcept
+{
+  using Vector = SIMDVector<SampleType>;
+  static_assert(numLanes<SampleType>() > 1, "a scalar has no lanes to shift");
+
+  // the native type follows from the element type and the width, comparing the types themselves trips -Wignored-attributes
+  constexpr auto isFloat = std::is_same_v<SampleType, float>;
+  constexpr auto width = Vector::size();
+
+#if JUCE_USE_SIMD && JUCE_INTEL
+  if constexpr (isFloat && width == 4) {
+    const auto shifted = _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v.value), 4));
+    return Vector::fromNative(_mm_move_ss(shifted, _mm_set_ss(x)));
+  } else if constexpr (!isFloat && width == 2) {
+    return Vector::fromNative(_mm_unpacklo_pd(_mm_set_sd(x), v.value));
+  } else
+ #if defined(__AVX2__)
+  if constexpr (isFloat && width == 8) {
+    const auto shifted = _mm256_permutevar8x32_ps(v.value, _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6));
+    return Vector::fromNative(_mm256_blend_ps(shifted, _mm256_set1_ps(x), 1));
+  } else if constexpr (!isFloat && width == 4) {
+    const auto shifted = _mm256_permute4x64_pd(v.value, _MM_SHUFFLE(2, 1, 0, 0));
+    return Vector::fromNative(_mm256_blend_pd(shifted, _mm256_set1_pd(x), 1));
+  } else
+ #endif
+#elif JUCE_USE_SIMD && JUCE_ARM
+  if constexpr (isFloat && width == 4) {
+    return Vector::fromNative(vextq_f32(vdupq_n_f32(x), v.value, 3));
+  } else
+#endif
+  {
+    Vector shifted {};
+    shifted.set(0, x);
+    for (size_t i = 1; i < Vector::size(); i++) {
+      shifted.set(i, v.get(i - 1));
+    }
+    return shifted;
+  }
+}
+
+/**
+ * @brief Flush denormal candidates of every lane to zero, like juce::dsp::IIR::Filter does after each block
+*/
+template <typename VectorType>
+inline void snapLanesToZero(VectorType &v) noexcept
+{
+  if constexpr (std::is_floating_point_v<VectorType>) {
+    juce::dsp::util::snapToZero(v);
+  } else {
+    for (size_t i = 0; i < VectorType::size(); i++) {
+      auto lane = v.get(i);
+      juce::dsp::util::snapToZero(lane);
+      v.set(i, lane);
+    }
+  }
+}
+
+} // namespace audio_plugin
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include "SimpleEQ/BandLayout.h"
+
+#include <array>
+#include <atomic>
+
+namespace audio_plugin {
+
+struct ChainSettings;
+
+/**
+ * @brief Publishes the chain parameters as one consistent, versioned snapshot
+ *
+ * The parameters are looked up once at construction. Whenever one of them changes, on whichever
+ * thread that happens, the settings are packed into a handful of words behind a sequence lock.
+ * Readers never block, they retry in the rare case that a write overlapped their copy, and can
+ * tell from the version alone whether anything changed since their last read.
+ *
+ * Writers don't block either: a writer that finds another one publishing leaves a request behind,
+ * and the active writer publishes again before it returns, so the last change is never lost.
+*/
+class ChainSettingsSnapshot : private juce::AudioProcessorParameter::Listener {
+public:
+  /**
+   * @brief A version that is never published, reading with it always returns the settings
+  */
+  static constexpr juce::uint32 noVersion = 1;
+
+  explicit ChainSettingsSnapshot(juce::AudioProcessorValueTreeState &apvts);
+  ~ChainSettingsSnapshot() override;
+
+  /**
+   * @brief Publish the current parameter values, e.g. after the whole state was replaced
+  */
+  void publish() noexcept;
+
+  /**
+   * @brief Version of the latest snapshot, it changes whenever a parameter changed
+  */
+  juce::uint32 getVersion() const noexcept { return sequence.load() & ~juce::uint32(1); }
+
+  /**
+   * @brief Read a consistent copy of the latest snapshot
+  */
+  ChainSettings read() const noexcept;
+
+  /**
+   * @brief Read the latest snapshot only if its version differs from lastVersion
+   * @param lastVersion The version of the last read, updated on success
+   * @param settings Receives the settings on success
+   * @return True if a newer snapshot was read
+  */
+  bool readIfChanged(juce::uint32 &lastVersion, ChainSettings &settings) const noexcept;
+
+private:
+  // five floats and the two slopes of the fixed bands, then type, frequency, gain and quality of every extra band
+  static constexpr size_t wordsPerBand = 4;
+  static constexpr size_t numWords = 6 + wordsPerBand * numExtraBands;
+  static constexpr size_t numParameters = 7 + wordsPerBand * numExtraBands;
+  using Words = std::array<juce::uint32, numWords>;
+
+  juce::AudioParameterFloat &lowCutFreq, &highCutFreq, &peakFreq, &peakGain, &peakQuality;
+  juce::AudioParameterChoice &lowCutSlope, &highCutSlope;
+
+  struct BandParameters {
+    juce::AudioParameterChoice *type {nullptr};
+    juce::AudioParameterFloat *freq {nullptr}, *gain {nullptr}, *quality {nullptr};
+  };
+  std::array<BandParameters, numExtraBands> bandParameters;
+
+  // odd while a writer is busy, the even values are the versions
+  std::atomic<juce::uint32> sequence {0};
+  std::atomic<juce::uint32> requests {0};
+  std::array<std::atomic<juce::uint32>, numWords> words {};
+
+  std::array<juce::AudioProcessorParameter *, numParameters> getParameters() noexcept;
+  Words pack() const noexcept;
+  Words load(juce::uint32 &version) const noexcept;
+  static ChainSettings unpack(const Words &packed) noexcept;
+
+  void parameterValueChanged(int parameterIndex, float newValue) override;
+  void parameterGestureChanged(int, bool) override {}
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChainSettingsSnapshot)
+};
+
+} // namespace audio_plugin
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <atomic>
+
+namespace audio_plugin {
+
+/**
+ * @brief Process-wide cache of designed stages, shared by every instance of the plugin
+ *
+ * Instances with identical settings, e.g. the same low cut in every channel strip of a template, find the
+ * coefficients another instance already designed. Lookups and insertions never block and never allocate, so
+ * both run on the audio thread: the table has a fixed size, and every slot is guarded by a sequence lock
+ * like the ChainSettingsSnapshot. A reader copies the coefficients out and retries elsewhere if a writer
+ * overlapped its copy, a writer that finds a slot busy simply doesn't insert. The key maps to a bucket of
+ * a few slots, a full bucket evicts its least recently used slot.
+ *
+ * Hold it through a juce::SharedResourcePointer, the cache lives as long as any instance does.
+*/
+class CoefficientCache {
+public:
+  /**
+   * @brief What a stage is designed from, stages with equal keys have equal coefficients
+  */
+  struct Key {
+    /**
+     * @brief Kind of the stage, never 0, which marks an empty slot
+    */
+    juce::uint32 kind {0};
+
+    /**
+     * @brief Slope of a cut filter, 0 for single section stages
+    */
+    juce::uint32 order {0};
+
+    float freq {0}, quality {0}, gainInDecibels {0};
+    double sampleRate {0};
+  };
+
+  /**
+   * @brief Raw double precision coefficients {b0, b1, b2, a0, a1, a2} of up to four sections
+  */
+  using Sections = std::array<std::array<double, 6>, 4>;
+
+  struct Statistics {
+    juce::uint64 hits {0}, misses {0}, insertions {0}, evictions {0};
+
+    double getHitRate() const noexcept
+    {
+      const auto lookups = hits + misses;
+      return lookups > 0 ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+    }
+  };
+
+  static constexpr size_t numBuckets = 256;
+  static constexpr size_t numWays = 4;
+
+  CoefficientCache() = default;
+
+  /**
+   * @brief Copy the sections stored for the key
+   * @return False if the key isn't cached or its slot was being written
+  */
+  bool lookup(const Key &key, Sections &sections) noexcept;
+
+  /**
+   * @brief Store the sections for the key, evicting the least recently used slot of its bucket if needed
+   * Does nothing if another thread is writing the same slot.
+  */
+  void insert(const Key &key, const Sections &sections) noexcept;
+
+  /**
+   * @brief Counters since the cache was created, summed over all instances
+  */
+  Statistics getStatistics() const noexcept;
+
+  /**
+   * @brief Drop every entry, only call this while no instance is processing, e.g. in tests
+  */
+  void clear() noexcept;
+
+private:
+  static constexpr size_t keyWords = 4;
+  static constexpr size_t sectionWords = 4 * 6;
+  using KeyWords = std::array<juce::uint64, keyWords>;
+
+  struct Slot {
+    // odd while a writer is busy
+    std::atomic<juce::uint32> sequence {0};
+    std::atomic<juce::uint32> lastUsed {0};
+    std::array<std::atomic<juce::uint64>, keyWords> key {};
+    std::array<std::atomic<juce::uint64>, sectionWords> sections {};
+  };
+
+  std::array<Slot, numBuckets * numWays> slots;
+
+  // ticks of the LRU clock, and the counters, each on its own cache line so they don't slow down the slots
+  alignas(64) std::atomic<juce::uint32> clock {0};
+  alignas(64) std::atomic<juce::uint64> hits {0};
+  alignas(64) std::atomic<juce::uint64> misses {0};
+  alignas(64) std::atomic<juce::uint64> insertions {0};
+  alignas(64) std::atomic<juce::uint64> evictions {0};
+
+  static KeyWords pack(const Key &key) noexcept;
+  static size_t getBucket(const KeyWords &words) noexcept;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CoefficientCache)
+};
+
+} // namespace audio_plugin
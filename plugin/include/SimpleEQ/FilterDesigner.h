@@ -0,0 +1,158 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <cmath>
+
+namespace audio_plugin {
+
+/**
+ * @brief Closed-form second order section designs that write raw {b0, b1, b2, a0, a1, a2} coefficients into fixed arrays
+ *
+ * Everything is computed in double precision and rounded once at the end, so the float and double designs describe
+ * the same filter. Nothing allocates, the designs are safe to call on the audio thread. The responses match
+ * juce::dsp::FilterDesign and juce::dsp::IIR::ArrayCoefficients within rounding.
+*/
+namespace filter_design {
+
+/**
+ * @brief Highest Butterworth order a cascade can be designed for, four sections
+*/
+constexpr int maxButterworthOrder = 8;
+
+/**
+ * @brief Damping 1/Q = 2 cos(theta) of every section of the even order Butterworth cascades, one row per order / 2
+ * theta is the angle of the section's pole pair, (2k + 1) pi / (2 order). The rows follow the section order of
+ * juce::dsp::FilterDesign, unused entries are zero.
+*/
+constexpr std::array<std::array<double, maxButterworthOrder / 2>, maxButterworthOrder / 2> butterworthDampings {{
+  {1.41421356237309505, 0.0, 0.0, 0.0},
+  {1.84775906502257351, 0.765366864730179543, 0.0, 0.0},
+  {1.93185165257813657, 1.41421356237309505, 0.517638090205041524, 0.0},
+  {1.96157056080646086, 1.66293922460509358, 1.11114046603920391, 0.390180644032256535}
+}};
+
+/**
+ * @brief Number of second order sections of a Butterworth cascade of the given even order
+*/
+constexpr size_t getNumButterworthSections(int order)
+{
+  return static_cast<size_t>(order / 2);
+}
+
+namespace detail {
+
+/**
+ * @brief Prewarped analog frequency of the bilinear transform, tan(pi f / fs)
+*/
+inline double prewarp(double sampleRate, double frequency) noexcept
+{
+  jassert(sampleRate > 0.0);
+  jassert(frequency > 0.0 && frequency < sampleRate * 0.5);
+  return std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+}
+
+template <typename SampleType>
+inline std::array<SampleType, 6> makeSection(double b0, double b1, double b2, double a0, double a1, double a2) noexcept
+{
+  return {static_cast<SampleType>(b0), static_cast<SampleType>(b1), static_cast<SampleType>(b2),
+          static_cast<SampleType>(a0), static_cast<SampleType>(a1), static_cast<SampleType>(a2)};
+}
+
+/**
+ * @brief Low or high pass section of damping 1/Q for the prewarped frequency k, already normalised to a0 = 1
+*/
+template <typename SampleType>
+inline std::array<SampleType, 6> makePass(double k, double damping, bool highPass) noexcept
+{
+  const auto kSquared = k * k;
+  const auto norm = 1.0 / (1.0 + damping * k + kSquared);
+  const auto a1 = 2.0 * (kSquared - 1.0) * norm;
+  const auto a2 = (1.0 - damping * k + kSquared) * norm;
+
+  if (highPass) {
+    return makeSection<SampleType>(norm, -2.0 * norm, norm, 1.0, a1, a2);
+  }
+
+  const auto b0 = kSquared * norm;
+  return makeSection<SampleType>(b0, 2.0 * b0, b0, 1.0, a1, a2);
+}
+
+template <typename SampleType, size_t maxSections>
+inline void designButterworth(std::array<std::array<SampleType, 6>, maxSections> &sections, int order,
+                              double sampleRate, double frequency, bool highPass) noexcept
+{
+  jassert(order >= 2 && order <= maxButterworthOrder && order % 2 == 0);
+  jassert(getNumButterworthSections(order) <= maxSections);
+
+  // every section shares the prewarped cutoff, a single tan for the whole cascade
+  const auto k = prewarp(sampleRate, frequency);
+  const auto &dampings = butterworthDampings[getNumButterworthSections(order) - 1];
+
+  for (size_t i = 0; i < getNumButterworthSections(order); i++) {
+    sections[i] = makePass<SampleType>(k, dampings[i], highPass);
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Even order Butterworth high pass, writes order / 2 sections and leaves the rest of the array untouched
+*/
+template <typename SampleType, size_t maxSections>
+inline void designButterworthHighPass(std::array<std::array<SampleType, 6>, maxSections> &sections, int order,
+                                      double sampleRate, double frequency) noexcept
+{
+  detail::designButterworth(sections, order, sampleRate, frequency, true);
+}
+
+/**
+ * @brief Even order Butterworth low pass, writes order / 2 sections and leaves the rest of the array untouched
+*/
+template <typename SampleType, size_t maxSections>
+inline void designButterworthLowPass(std::array<std::array<SampleType, 6>, maxSections> &sections, int order,
+                                     double sampleRate, double frequency) noexcept
+{
+  detail::designButterworth(sections, order, sampleRate, frequency, false);
+}
+
+/**
+ * @brief Second order high pass of the given quality, e.g. for a single section band
+*/
+template <typename SampleType>
+inline std::array<SampleType, 6> designHighPass(double sampleRate, double frequency, double quality) noexcept
+{
+  jassert(quality > 0.0);
+  return detail::makePass<SampleType>(detail::prewarp(sampleRate, frequency), 1.0 / quality, true);
+}
+
+/**
+ * @brief Second order low pass of the given quality, e.g. for a single section band
+*/
+template <typename SampleType>
+inline std::array<SampleType, 6> designLowPass(double sampleRate, double frequency, double quality) noexcept
+{
+  jassert(quality > 0.0);
+  return detail::makePass<SampleType>(detail::prewarp(sampleRate, frequency), 1.0 / quality, false);
+}
+
+/**
+ * @brief RBJ peak of the given linear gain, numerator and denominator are identical at unity gain
+*/
+template <typename SampleType>
+inline std::array<SampleType, 6> designPeak(double sampleRate, double frequency, double quality, double gainFactor) noexcept
+{
+  jassert(sampleRate > 0.0 && quality > 0.0);
+
+  const auto a = std::sqrt(juce::jmax(0.0, gainFactor));
+  const auto omega = 2.0 * juce::MathConstants<double>::pi * juce::jmax(frequency, 2.0) / sampleRate;
+  const auto alpha = std::sin(omega) / (2.0 * quality);
+  const auto c2 = -2.0 * std::cos(omega);
+
+  return detail::makeSection<SampleType>(1.0 + alpha * a, c2, 1.0 - alpha * a, 1.0 + alpha / a, c2, 1.0 - alpha / a);
+}
+
+} // namespace filter_design
+
+} // namespace audio_plugin
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include "SimpleEQ/ChainSettingsSnapshot.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace audio_plugin {
+
+class ResponseCurve;
+
+/**
+ * @brief Linear-phase version of the chain, a symmetric FIR with the magnitude response of the IIR stages
+ *
+ * The kernel is designed on a background thread whenever the published chain settings change: the
+ * magnitude of the chain is evaluated on the bins of an FFT, transformed back with zero phase, centred
+ * and windowed. It runs through juce::dsp::Convolution with a non-uniformly partitioned engine, which
+ * prepares new kernels on a message queue and crossfades to them on the audio thread. The filter delays
+ * the signal by half the kernel length.
+ *
+ * All instances share one design thread and one message queue, so the number of threads doesn't grow
+ * with the number of instances.
+*/
+class LinearPhaseFilter : private juce::TimeSliceClient {
+public:
+  /**
+   * @brief Length of the kernel, rounded up to a power of two, long enough for the steepest low cut
+  */
+  static constexpr double kernelLengthInSeconds = 0.1;
+
+  /**
+   * @brief Size of the uniformly partitioned head of the convolution, the tail uses larger partitions
+  */
+  static constexpr int headSize = 256;
+
+  /**
+   * @brief How often the background thread looks for new settings while the filter is in use
+  */
+  static constexpr int pollIntervalMs = 30;
+
+  explicit LinearPhaseFilter(const ChainSettingsSnapshot &);
+  ~LinearPhaseFilter() override;
+
+  /**
+   * @brief Allocate the convolutions, design the first kernel and register with the design thread
+   * @param designSampleRate The rate the IIR stages are designed for, the magnitude is taken from those designs
+  */
+  void prepare(const juce::dsp::ProcessSpec &spec, double designSampleRate);
+
+  void reset() noexcept;
+
+  /**
+   * @brief Tell the background thread whether kernels are needed, it idles while the filter is unused
+  */
+  void setActive(bool shouldBeActive) noexcept { active.store(shouldBeActive); }
+
+  /**
+   * @brief Change the rate the magnitude response is evaluated at, e.g. when the oversampling factor changed
+  */
+  void setDesignSampleRate(double newDesignSampleRate) noexcept { designSampleRate.store(newDesignSampleRate); }
+
+  void process(const juce::dsp::ProcessContextReplacing<float> &context) noexcept;
+
+  /**
+   * @brief Delay of the centred kernel, valid after prepare
+  */
+  int getLatencyInSamples() const noexcept { return kernelLength / 2; }
+
+private:
+  struct DesignThread : juce::TimeSliceThread {
+    DesignThread() : juce::TimeSliceThread("Linear Phase Kernel Design") { startThread(juce::Thread::Priority::low); }
+    ~DesignThread() override { stopThread(1000); }
+  };
+
+  const ChainSettingsSnapshot &snapshot;
+
+  juce::SharedResourcePointer<juce::dsp::ConvolutionMessageQueue> messageQueue;
+  juce::SharedResourcePointer<DesignThread> designThread;
+
+  // juce::dsp::Convolution handles up to two channels, wider layouts use one per pair of channels
+  std::vector<std::unique_ptr<juce::dsp::Convolution>> convolutions;
+
+  double sampleRate {0.0};
+  int kernelLength {0};
+
+  std::atomic<bool> active {false};
+  std::atomic<double> designSampleRate {0.0};
+
+  // only used by the design thread once the filter is prepared
+  std::unique_ptr<ResponseCurve> response;
+  std::unique_ptr<juce::dsp::FFT> fft;
+  std::vector<double> binFrequencies;
+  std::vector<float> fftBuffer, window;
+  juce::uint32 designedVersion {ChainSettingsSnapshot::noVersion};
+  double designedSampleRate {0.0};
+
+  int useTimeSlice() override;
+
+  /**
+   * @brief Design a kernel if the settings or the design rate changed and hand it to every convolution
+  */
+  void updateKernel();
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LinearPhaseFilter)
+};
+
+} // namespace audio_plugin
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "PluginProcessor.h"
+#include "ResponseCurveRenderer.h"
+#include "SpectrumAnalyzer.h"
+
+#include <memory>
 
 namespace audio_plugin {
 
@@ -34,28 +38,131 @@ private:
   juce::String suffix;
 };
 
-struct ResponseCurveComponent : juce::Component, juce::AudioProcessorParameter::Listener, juce::Timer {
+/**
+ * @brief Response curve and spectra, updated only while something changes
+ *
+ * Instead of a fixed rate timer the component draws on the display's vertical blank while it has work:
+ * a parameter changed, a requested frame hasn't arrived yet, or a spectrum moved. Parameter notifications
+ * only set a flag, so a burst of them between two vertical blanks results in one render. Silence doesn't
+ * move the spectra once they rest on the floor, so after a short stretch without work the attachment is
+ * dropped. Changes that happen behind the component's back, host automation on the audio thread and
+ * audio arriving, only set flags, which a slow watch timer looks at while the component sleeps. Audio
+ * only wakes it if the spectra moved, a steady tone doesn't keep it drawing.
+*/
+struct ResponseCurveComponent : juce::Component, juce::AudioProcessorParameter::Listener, private juce::Timer {
   ResponseCurveComponent(SimpleEQAudioProcessor&);
   ~ResponseCurveComponent() override;
 
   void parameterValueChanged(int parameterIndex, float newValue) override;
   void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override;
 
-  void timerCallback() override;
-
   void paint(juce::Graphics &) override;
-  //void resized() override;
+  void resized() override;
 
 private:
+  /**
+   * @brief Level range of the spectra, the response curve has its own scale
+  */
+  static constexpr float spectrumMinDecibels = -72.f;
+  static constexpr float spectrumMaxDecibels = 0.f;
+
+  /**
+   * @brief Vertical blanks without any work before the component goes to sleep, about half a second at 60 Hz
+   * Long enough to bridge the gaps between the blocks of a host with large buffers.
+  */
+  static constexpr int idleFramesBeforeSleeping = 30;
+
+  /**
+   * @brief Interval of the watch timer while the component sleeps
+  */
+  static constexpr int watchIntervalMilliseconds = 100;
+
   SimpleEQAudioProcessor &processorRef;
   juce::Atomic<bool> parametersChanged {false};
+
+  /**
+   * @brief Calls onVBlank() while the component is awake, empty while it sleeps
+  */
+  std::unique_ptr<juce::VBlankAttachment> vBlankAttachment;
+  int idleFrames {0};
+
+  /**
+   * @brief Grid and frame, rendered once per resize
+  */
   juce::Image background;
 
-  MonoChain monoChain;
+  /**
+   * @brief Draws the curve off the message thread, paint() only composites the finished frame
+  */
+  ResponseCurveRenderer renderer;
+
+  /**
+   * @brief Spectra before and after the EQ, analysed on the vertical blank and drawn behind the curve
+  */
+  SpectrumAnalyzer inputAnalyzer, outputAnalyzer;
+  juce::Path inputSpectrumPath, outputSpectrumPath;
+  double analyzerSampleRate {0.0};
+
+  void renderBackground();
+
+  /**
+   * @brief Start drawing on the vertical blank, only call this from the message thread
+  */
+  void wakeUp();
+
+  /**
+   * @brief Pick up the changes since the last vertical blank and go to sleep once there were none for a while
+  */
+  void onVBlank();
+
+  /**
+   * @brief Drop the attachment, arm the processor's EditorWakeUp and start the watch timer
+  */
+  void goToSleep();
+
+  /**
+   * @brief The watch timer, wakes the component if parameters changed or audio moved the spectra while it slept
+  */
+  void timerCallback() override;
+
+  /**
+   * @brief Drain the analyzer FIFOs and rebuild the spectrum paths
+   * @return True if either spectrum changed
+  */
+  bool updateSpectra();
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ResponseCurveComponent)
 };
 
+/**
+ * @brief Compact table of the p50 and p99 time per block of every profiled section, over the last second
+ * The histograms only ever count up, the overlay keeps the snapshot of one second ago and looks at the difference.
+*/
+struct ProfilerOverlay : juce::Component, private juce::Timer {
+  explicit ProfilerOverlay(const Profiler &);
+
+  void paint(juce::Graphics &) override;
+
+  static constexpr int rowHeight = 12;
+  static constexpr int width = 150;
+  static constexpr int height = rowHeight * (Profiler::numSections + 1) + 4;
+
+private:
+  static constexpr int intervalMilliseconds = 1000;
+
+  const Profiler &profiler;
+  std::array<DurationHistogram::Counts, Profiler::numSections> previous {};
+
+  /**
+   * @brief p50 and p99 of each section in microseconds, 0 if it didn't run in the last interval
+  */
+  std::array<std::array<double, 2>, Profiler::numSections> percentiles {};
+
+  void timerCallback() override;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfilerOverlay)
+};
+
 class SimpleEQEditor : public juce::AudioProcessorEditor
 {
 public:
@@ -70,6 +177,7 @@ private:
   // access the processor object that created it.
   SimpleEQAudioProcessor &processorRef;
   ResponseCurveComponent responseCurveComponent;
+  ProfilerOverlay profilerOverlay;
 
   RotarySliderWithLabels peakFreqSlider, peakGainSlider, peakQualitySlider;
   RotarySliderWithLabels lowCutFreqSlider, lowCutSlopeSlider;
@@ -3,6 +3,19 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 
+#include "SimpleEQ/AnalyzerFifo.h"
+#include "SimpleEQ/BandLayout.h"
+#include "SimpleEQ/ChainSettingsSnapshot.h"
+#include "SimpleEQ/CoefficientCache.h"
+#include "SimpleEQ/LinearPhaseFilter.h"
+#include "SimpleEQ/PresetBank.h"
+#include "SimpleEQ/Profiler.h"
+#include "SimpleEQ/SIMDFilterChain.h"
+#include "SimpleEQ/SVFFilterChain.h"
+
+#include <atomic>
+#include <vector>
+
 namespace audio_plugin {
 
 enum Slope {
@@ -12,6 +25,35 @@ enum Slope {
   Slope_48
 };
 
+/**
+ * @brief Number of second order sections a cut filter needs for the given slope
+*/
+constexpr size_t getNumSections(Slope slope)
+{
+  return static_cast<size_t>(slope) + 1;
+}
+
+/**
+ * @brief Filter types of the extra bands, the order matches the choices of the "Band N Type" parameters
+*/
+enum class BandType {
+  Off,
+  Peak,
+  LowShelf,
+  HighShelf,
+  Notch,
+  LowCut,
+  HighCut
+};
+
+/**
+ * @brief Settings of one extra band, a single second order section
+*/
+struct BandSettings {
+  BandType type {BandType::Off};
+  float freq {1000.f}, gainInDecibels {0}, quality {1.f};
+};
+
 /**
  * @brief The ChainSettings struct holds the settings for the filter chain
 */
@@ -19,20 +61,156 @@ struct ChainSettings {
   float peakFreq {0}, peakGainInDecibels {0}, peakQuality {1.f};
   float lowCutFreq {0}, highCutFreq {0};
   Slope lowCutSlope {Slope::Slope_12}, highCutSlope {Slope::Slope_12};
+
+  /**
+   * @brief The bands after LowCut, Peak and HighCut
+  */
+  std::array<BandSettings, numExtraBands> bands;
 };
 
+/**
+ * @brief ID of a parameter of an extra band, e.g. "Band 4 Gain", the bands are numbered by their position in the chain
+*/
+juce::String getBandParameterID(size_t extraBand, const juce::String &name);
+
 /**
  * @brief Get the Chain Settings object
+ * Looks every parameter up by its ID, use the processor's ChainSettingsSnapshot on hot paths.
  * @param apvts The AudioProcessorValueTreeState object
  * @return The ChainSettings object
 */
 ChainSettings getChainSettings(juce::AudioProcessorValueTreeState &apvts);
 
-using Filter = juce::dsp::IIR::Filter<float>;
+/**
+ * @brief The chain parameters in the order setChainSettings() writes them
+*/
+using ChainParameters = std::vector<juce::RangedAudioParameter *>;
+
+ChainParameters getChainParameters(juce::AudioProcessorValueTreeState &apvts);
+
+/**
+ * @brief Set every chain parameter to the given settings and notify the host, e.g. to load a program
+*/
+void setChainSettings(juce::AudioProcessorValueTreeState &apvts, const ChainSettings &settings);
+
+/**
+ * @brief Same as above with the parameters resolved up front, without lookups or allocations
+ * Program changes may arrive on the audio thread, e.g. through the program parameter of a VST3 host.
+*/
+void setChainSettings(const ChainParameters &parameters, const ChainSettings &settings) noexcept;
+
+/**
+ * @brief Round the settings to the values the parameters would hold after setChainSettings()
+*/
+ChainSettings quantizeChainSettings(juce::AudioProcessorValueTreeState &apvts, const ChainSettings &settings);
+
+/**
+ * @brief Version counters for the independently designed stages of the chain
+*/
+struct ChainVersions {
+  juce::uint32 lowCut {0}, peak {0}, highCut {0};
+  std::array<juce::uint32, numExtraBands> bands {};
+};
+
+/**
+ * @brief Tracks the parameters feeding each stage and bumps the stage's version whenever one of them changed
+*/
+class ChainSettingsTracker {
+public:
+  /**
+   * @brief Compare the settings against the previously seen ones
+   * @param settings The current chain settings
+   * @return The versions of all stages after the comparison
+  */
+  ChainVersions update(const ChainSettings &settings) noexcept;
+
+  /**
+   * @brief Mark every stage as changed, e.g. after the sample rate changed
+  */
+  void invalidate() noexcept;
+
+private:
+  ChainSettings last;
+  ChainVersions versions;
+  bool valid {false};
+};
+
+/**
+ * @brief Ramps the continuous chain settings towards the parameter values for zipper-free automation
+ *
+ * The coefficients are redesigned every updateInterval samples from the ramped settings and interpolated
+ * in between, so the size of the steps does not depend on the host buffer size.
+*/
+class ChainSmoother {
+public:
+  /**
+   * @brief Number of samples between two coefficient designs
+  */
+  static constexpr int updateInterval = 32;
+
+  /**
+   * @brief Time it takes a ramp to reach a new parameter value
+  */
+  static constexpr double rampLengthInSeconds = 0.05;
+
+  /**
+   * @brief Set the sample rate and jump to the given settings without ramping
+  */
+  void reset(double sampleRate, const ChainSettings &settings) noexcept;
+
+  /**
+   * @brief Start ramping towards new settings, slopes are switched immediately
+  */
+  void setTarget(const ChainSettings &settings) noexcept;
+
+  /**
+   * @brief Advance all ramps
+   * @param numSamples The number of samples to advance
+   * @return The settings reached after numSamples
+  */
+  ChainSettings skip(int numSamples) noexcept;
+
+private:
+  juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> lowCutFreq, highCutFreq, peakFreq;
+  juce::SmoothedValue<float> peakGainInDecibels, peakQuality;
+  Slope lowCutSlope {Slope::Slope_12}, highCutSlope {Slope::Slope_12};
+
+  struct BandSmoother {
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> freq;
+    juce::SmoothedValue<float> gainInDecibels, quality;
+    BandType type {BandType::Off};
+  };
+  std::array<BandSmoother, numExtraBands> bands;
+};
+
+template <typename SampleType>
+using BasicFilter = juce::dsp::IIR::Filter<SampleType>;
 
-using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;
+template <typename SampleType>
+using BasicCutFilter = juce::dsp::ProcessorChain<BasicFilter<SampleType>, BasicFilter<SampleType>, 
+                                                 BasicFilter<SampleType>, BasicFilter<SampleType>>;
 
-using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter>;
+template <typename SampleType>
+using BasicMonoChain = juce::dsp::ProcessorChain<BasicCutFilter<SampleType>, BasicFilter<SampleType>, BasicCutFilter<SampleType>>;
+
+using Filter = BasicFilter<float>;
+using CutFilter = BasicCutFilter<float>;
+using MonoChain = BasicMonoChain<float>;
+
+/**
+ * @brief Processes all channels through the same coefficients, several channels per vectorized pass
+*/
+using MultiChannelChain = SIMDFilterChain<float>;
+using DoubleMultiChannelChain = SIMDFilterChain<double>;
+
+/**
+ * @brief The alternative engine, state variable filters that can be modulated on every sample
+*/
+using StateVariableChain = SVFFilterChain<float>;
+using DoubleStateVariableChain = SVFFilterChain<double>;
+
+static_assert(maxBands <= MultiChannelChain::maxStages, "every band needs a stage of the chain");
+static_assert(maxBands <= StateVariableChain::maxStages, "every band needs a stage of the chain");
 
 /**
  * @brief Enum for the Chain positions in the filter chain
@@ -48,9 +226,86 @@ enum ChainPositions {
 */
 using Coefficients = Filter::CoefficientsPtr;
 
-void updateCoefficients(Coefficients &old, const Coefficients &replacements);
+/**
+ * @brief Raw, unnormalised coefficients of a single second order section {b0, b1, b2, a0, a1, a2}
+*/
+template <typename SampleType>
+using BasicSectionCoefficients = std::array<SampleType, 6>;
+
+/**
+ * @brief Fixed storage for the sections of a cut filter, 48 dB/Oct needs four of them
+*/
+template <typename SampleType>
+using BasicCutCoefficients = std::array<BasicSectionCoefficients<SampleType>, 4>;
+
+using SectionCoefficients = BasicSectionCoefficients<float>;
+using CutCoefficients = BasicCutCoefficients<float>;
+
+template <typename SampleType>
+void updateCoefficients(juce::ReferenceCountedObjectPtr<juce::dsp::IIR::Coefficients<SampleType>> &old, 
+                        const juce::ReferenceCountedObjectPtr<juce::dsp::IIR::Coefficients<SampleType>> &replacements)
+{
+  *old = *replacements;
+}
+
+/**
+ * @brief Assign raw section coefficients without touching the heap
+*/
+template <typename SampleType>
+void updateCoefficients(juce::ReferenceCountedObjectPtr<juce::dsp::IIR::Coefficients<SampleType>> &old, 
+                        const BasicSectionCoefficients<SampleType> &replacements)
+{
+  // Coefficients keeps its storage, so assigning a fixed size array never reallocates
+  *old = replacements;
+}
+
+template <typename SampleType = float>
+typename BasicFilter<SampleType>::CoefficientsPtr makePeakFilter(const ChainSettings &chainSettings, double sampleRate);
+
+/**
+ * @brief Allocation free counterparts of the make*Filter functions, safe to call on the audio thread
+ * Instantiated for float and double, the chain of each precision gets coefficients designed in that precision.
+*/
+template <typename SampleType = float>
+BasicSectionCoefficients<SampleType> designPeakFilter(const ChainSettings &chainSettings, double sampleRate);
+template <typename SampleType = float>
+BasicCutCoefficients<SampleType> designLowCutFilter(const ChainSettings &chainSettings, double sampleRate);
+template <typename SampleType = float>
+BasicCutCoefficients<SampleType> designHighCutFilter(const ChainSettings &chainSettings, double sampleRate);
+
+/**
+ * @brief Design the single section of an extra band, an Off band gets the identity
+*/
+template <typename SampleType = float>
+BasicSectionCoefficients<SampleType> designBand(const BandSettings &band, double sampleRate);
+
+/**
+ * @brief Set every stage of a state variable chain to the same responses the design functions produce
+ * @param rampLength Number of samples over which frequency, quality and gain move to the new settings
+*/
+template <typename SampleType>
+void setStateVariableChain(SVFFilterChain<SampleType> &chain, const ChainSettings &chainSettings, double sampleRate, 
+                           size_t rampLength = 0) noexcept;
+
+/**
+ * @brief Level, relative to the last input, below which the ringing of the chain counts as decayed
+*/
+constexpr double tailDecayDecibels = -120.0;
+
+/**
+ * @brief Time the designed chain needs to decay by tailDecayDecibels once the input stops
+ * Every section contributes the decay time of its slowest pole, so steep slopes and high quality
+ * factors give longer tails. Flat and switched off bands don't contribute.
+*/
+double calculateTailLengthSeconds(const ChainSettings &chainSettings, double sampleRate);
 
-Coefficients makePeakFilter(const ChainSettings &chainSettings, double sampleRate);
+/**
+ * @brief Number of sections an extra band occupies in the chain
+*/
+constexpr size_t getNumSections(const BandSettings &band)
+{
+  return band.type == BandType::Off ? 0 : 1;
+}
 
 /**
  * @brief Update coefficients for the filter chain 
@@ -91,25 +346,63 @@ void updateCutFilters(ChainType &chain, const CoefficientType &coefficients, con
   };
 }
 
+template <typename SampleType = float>
 inline auto makeLowCutFilter(const ChainSettings &chainSettings, double sampleRate)
 {
-  return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(chainSettings.lowCutFreq, 
-                                                                                    sampleRate, 
-                                                                                    2 * (chainSettings.lowCutSlope + 1));
+  return juce::dsp::FilterDesign<SampleType>::designIIRHighpassHighOrderButterworthMethod(chainSettings.lowCutFreq, 
+                                                                                         sampleRate, 
+                                                                                         2 * (chainSettings.lowCutSlope + 1));
 }
 
+template <typename SampleType = float>
 inline auto makeHighCutFilter(const ChainSettings &chainSettings, double sampleRate)
 {
-  return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq, 
-                                                                                    sampleRate, 
-                                                                                    2 * (chainSettings.highCutSlope + 1)
+  return juce::dsp::FilterDesign<SampleType>::designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq, 
+                                                                                        sampleRate, 
+                                                                                        2 * (chainSettings.highCutSlope + 1)
   );
 }
 
+/**
+ * @brief Tells a sleeping editor that audio arrived, without the audio thread ever posting a message
+ *
+ * The editor arms it when it goes to sleep and polls it with a slow timer until it wakes up again. A
+ * request only stores a flag, while the editor is awake or no editor is attached it is a single load.
+*/
+class EditorWakeUp {
+public:
+  /**
+   * @brief Only call this from the message thread
+  */
+  void setArmed(bool shouldBeArmed) noexcept
+  {
+    armed.store(shouldBeArmed, std::memory_order_relaxed);
+    requested.store(false, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Callable from any thread, never blocks or posts
+  */
+  void request() noexcept
+  {
+    if (armed.load(std::memory_order_relaxed) && !requested.load(std::memory_order_relaxed)) {
+      requested.store(true, std::memory_order_release);
+    }
+  }
+
+  /**
+   * @brief Whether anything was requested since the last call, only call this from the message thread
+  */
+  bool consumeRequest() noexcept { return requested.exchange(false, std::memory_order_acquire); }
+
+private:
+  std::atomic<bool> armed {false}, requested {false};
+};
+
 /**
  * @brief The Audio Processor class for the SimpleEQ plugin
 */
-class SimpleEQAudioProcessor : public juce::AudioProcessor 
+class SimpleEQAudioProcessor : public juce::AudioProcessor, private juce::AudioProcessorParameter::Listener
 {
 public:
   SimpleEQAudioProcessor();
@@ -129,7 +422,13 @@ public:
    * @param midiMessages The midi buffer
   */
   void processBlock(juce::AudioBuffer<float> &, juce::MidiBuffer &) override;
-  using AudioProcessor::processBlock;
+
+  /**
+   * @brief Double precision counterpart, every stage runs in double
+  */
+  void processBlock(juce::AudioBuffer<double> &, juce::MidiBuffer &) override;
+
+  bool supportsDoublePrecisionProcessing() const override;
 
   juce::AudioProcessorEditor *createEditor() override;
   bool hasEditor() const override;
@@ -149,14 +448,47 @@ public:
 
   /**
    * @brief Get the state information of all plugin parameters
+   * Writes the compact binary format: stateMagic, stateVersion, the program, the number of parameters
+   * and for every parameter its getStateKey() followed by its normalised value.
   */
   void getStateInformation(juce::MemoryBlock &destData) override;
 
   /**
    * @brief Set the state information of all plugin parameters
+   * Reads the binary format, or the ValueTree that older versions of the plugin stored.
   */
   void setStateInformation(const void *data, int sizeInBytes) override;
 
+  /**
+   * @brief Marks the binary state format, "SEQB", anything else is read as a ValueTree
+  */
+  static constexpr int stateMagic = 0x53455142;
+
+  /**
+   * @brief Version of the binary state format
+   * Version 1 stored the values by their index in the layout, which breaks as soon as a parameter is inserted
+   * before others, version 2 stores a key with every value and matches them by key.
+  */
+  static constexpr int stateVersion = 2;
+
+  /**
+   * @brief Key of a parameter in the binary state, the 32 bit FNV-1a hash of the UTF-8 of its ID
+   * Doesn't depend on the position of the parameter in the layout or on JUCE's string hashing.
+  */
+  static juce::uint32 getStateKey(const juce::String &parameterID) noexcept;
+
+  /**
+   * @brief Length of the crossfade from the outgoing to the incoming program
+  */
+  static constexpr double programFadeSeconds = 0.02;
+
+  const PresetBank &getPresetBank() const noexcept { return presetBank; }
+
+  /**
+   * @brief Hit rate and size of the coefficient cache all instances share
+  */
+  CoefficientCache::Statistics getCoefficientCacheStatistics() const noexcept { return coefficientCache->getStatistics(); }
+
   /*** User defined functions ***/ 
 
   /**
@@ -170,22 +502,330 @@ public:
   */
   juce::AudioProcessorValueTreeState apvts {*this, nullptr, "Parameters", createParameterLayout()};
 
+  /**
+   * @brief Consistent, versioned copy of the chain parameters for the audio thread, the editor and any other reader
+  */
+  const ChainSettingsSnapshot &getChainSettingsSnapshot() const noexcept { return chainSettingsSnapshot; }
+
+  /**
+   * @brief Sample rate the filters are designed for, the host's rate times the selected oversampling factor
+  */
+  double getFilterSampleRate() const noexcept;
+
+  /**
+   * @brief Redesign only the stages whose parameters changed since the last call
+   * Called by processBlock, public so that its cost can be measured on its own.
+  */
+  void updateFilters();
+
+  /**
+   * @brief Which stages run in double precision while the host processes floats
+   * Single runs everything in float, Automatic only the stages whose poles come closer to the unit circle
+   * than illConditionedDistance, e.g. a steep low cut at 20 Hz and 192 kHz, Double runs every stage in double.
+  */
+  enum class PrecisionMode {
+    Single,
+    Automatic,
+    Double
+  };
+
+  static constexpr double illConditionedDistance = 1.0e-3;
+
+  /**
+   * @brief Internal option, not a host parameter, the audio thread picks it up on its next block
+  */
+  void setPrecisionMode(PrecisionMode mode) noexcept { precisionMode.store(mode); }
+
+  /**
+   * @brief The filters the IIR path runs, the biquad chains or the state variable chain
+   * The state variable engine follows the parameters with a per sample ramp instead of redesigning coefficients,
+   * in smoothing mode the ramp takes ChainSmoother::rampLengthInSeconds. It runs in the host's precision, its
+   * low frequency stages don't lose precision like the biquads do, so the PrecisionMode doesn't apply to it.
+  */
+  enum class FilterEngine {
+    Biquad,
+    StateVariable
+  };
+
+  /**
+   * @brief Internal option per instance, not a host parameter, the audio thread picks it up on its next block
+  */
+  void setFilterEngine(FilterEngine engine) noexcept { filterEngine.store(engine); }
+
+  /**
+   * @brief Peak level below which an input block counts as digital silence, about -160 dBFS
+  */
+  static constexpr float silenceThreshold = 1.0e-8f;
+
+  /**
+   * @brief Mono mix of the audio before and after the EQ, only fed while a SpectrumAnalyzer is attached
+  */
+  AnalyzerFifo &getInputAnalyzerFifo() noexcept { return inputAnalyzerFifo; }
+  AnalyzerFifo &getOutputAnalyzerFifo() noexcept { return outputAnalyzerFifo; }
+
+  /**
+   * @brief Timings of the sections of every block, read by the editor
+  */
+  const Profiler &getProfiler() const noexcept { return profiler; }
+
+  /**
+   * @brief Requested by the audio thread for every block that isn't idle, see ResponseCurveComponent
+  */
+  EditorWakeUp &getEditorWakeUp() noexcept { return editorWakeUp; }
+
 private:
 
+  ChainSettingsSnapshot chainSettingsSnapshot {apvts};
+
+  AnalyzerFifo inputAnalyzerFifo, outputAnalyzerFifo;
+  EditorWakeUp editorWakeUp;
+
+  /**
+   * @brief Resolved once, processBlock reads it on every call
+  */
+  juce::AudioParameterBool &smoothingParameter;
+
+  /**
+   * @brief Oversampling choice, the index is the base 2 logarithm of the factor
+  */
+  juce::AudioParameterChoice &oversamplingParameter;
+
+  /**
+   * @brief One oversampler per factor, created in prepareToPlay so switching never allocates, none for 1x
+  */
+  std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, 3> oversamplers;
+  std::array<std::unique_ptr<juce::dsp::Oversampling<double>>, 3> doubleOversamplers;
+
+  /**
+   * @brief Latency of each factor, written by prepareToPlay and read by the parameter listener on the message thread
+  */
+  std::array<std::atomic<int>, 3> oversamplingLatencies {};
+
+  /**
+   * @brief Linear-phase mode, runs instead of the IIR chain and the oversampling
+  */
+  juce::AudioParameterBool &linearPhaseParameter;
+  LinearPhaseFilter linearPhaseFilter {chainSettingsSnapshot};
+  std::atomic<int> linearPhaseLatency {0};
+  bool linearPhaseActive {false};
+
+  /**
+   * @brief The factor the audio thread currently runs at and the sample rate the chain is designed for
+  */
+  int activeOversampling {0};
+  double processingSampleRate {44100.0};
+
+  /**
+   * @brief Version of the snapshot the stages were last compared against
+  */
+  juce::uint32 snapshotVersion {ChainSettingsSnapshot::noVersion};
+
+  /**
+   * @brief The chain for all channels of the main bus, the channels share the coefficients and run in separate lanes
+  */
+  MultiChannelChain chain;
+
   /**
-   * @brief The Stereo Chain Objects
+   * @brief The stages that run in double precision, every stage when the host processes doubles
   */
-  MonoChain leftChain, rightChain;
+  DoubleMultiChannelChain doubleChain;
+  std::array<bool, maxBands> stagesInDouble {};
+
+  std::atomic<PrecisionMode> precisionMode {PrecisionMode::Automatic};
+  PrecisionMode activePrecisionMode {PrecisionMode::Automatic};
+  bool doubleProcessing {false};
+
+  /**
+   * @brief Conversion buffers, for the double stages of a float block and for the float-only convolution of a double block
+  */
+  juce::AudioBuffer<double> doubleScratch;
+  juce::AudioBuffer<float> floatScratch;
+
+  /**
+   * @brief The chains of the state variable engine, one per precision of the host
+  */
+  StateVariableChain stateVariableChain;
+  DoubleStateVariableChain doubleStateVariableChain;
+  std::atomic<FilterEngine> filterEngine {FilterEngine::Biquad};
+  FilterEngine activeFilterEngine {FilterEngine::Biquad};
+  juce::uint32 stateVariableVersion {ChainSettingsSnapshot::noVersion};
+
+  /**
+   * @brief Samples left of the glide to a new program, the state variable engine glides instead of crossfading
+  */
+  int programGlideRemaining {0};
+
+  /**
+   * @brief Designs shared with every other instance in the process
+  */
+  juce::SharedResourcePointer<CoefficientCache> coefficientCache;
+
+  /**
+   * @brief Programs with precomputed coefficients, the message thread requests one and the audio thread switches to it
+  */
+  PresetBank presetBank {apvts};
+  ChainParameters chainParameters {getChainParameters(apvts)};
+  std::atomic<int> requestedProgram {0};
+  int activeProgram {0};
+
+  /**
+   * @brief The chains of the outgoing program, they keep running on a copy of the input while the crossfade lasts
+  */
+  MultiChannelChain fadeChain;
+  DoubleMultiChannelChain doubleFadeChain;
+  juce::AudioBuffer<float> fadeScratch;
+  juce::AudioBuffer<double> doubleFadeScratch;
+  int fadeLength {0};
+  int fadeRemaining {0};
+
+  /**
+   * @brief Stage versions of the parameters and the versions the chains were last designed for
+  */
+  ChainSettingsTracker settingsTracker;
+  ChainVersions appliedVersions;
+
+  /**
+   * @brief State of the smoothing mode, the ramped settings are tracked separately from the parameters
+  */
+  ChainSmoother smoother;
+  ChainSettingsTracker smoothedTracker;
+  ChainVersions appliedSmoothedVersions;
+  int samplesUntilSmoothingUpdate {0};
+  bool smoothingActive {false};
+
+  /**
+   * @brief Tail of the current settings in samples at the host's rate, recomputed whenever the snapshot or the mode changes
+  */
+  juce::int64 tailLengthInSamples {0};
+  juce::uint32 tailVersion {ChainSettingsSnapshot::noVersion};
+  int tailMode {0};
+
+  /**
+   * @brief Samples of digital silence since the last audible input, processing stops once they cover the tail
+  */
+  juce::int64 silentSamples {0};
+  bool idle {false};
+
+  Profiler profiler;
+
+  /**
+   * @brief Only in the standalone target, and only if ProfileTraceWriter::environmentVariable names a file
+  */
+  std::unique_ptr<ProfileTraceWriter> traceWriter;
 
   /**
    * @brief Update the Peak filter
+   * @param rampLength Number of samples over which the new coefficients are interpolated
   */
-  void updatePeakFilter(const ChainSettings &chainSettings);
+  void updatePeakFilter(const ChainSettings &chainSettings, size_t rampLength = 0);
 
-  void updateLowCutFilters(const ChainSettings &chainSettings);
-  void updateHighCutFilters(const ChainSettings &chainSettings);
+  void updateLowCutFilters(const ChainSettings &chainSettings, size_t rampLength = 0);
+  void updateHighCutFilters(const ChainSettings &chainSettings, size_t rampLength = 0);
+  void updateBand(size_t band, const BandSettings &bandSettings, size_t rampLength = 0);
 
-  void updateFilters();
+  /**
+   * @brief Look the stage up in the shared cache, design it in double precision on a miss
+   * @param rampLength The ramp the design is used for, ramped designs bypass the cache
+   * @param design Returns the sections of the stage
+  */
+  template <typename DesignFunction>
+  BasicCutCoefficients<double> designStage(const CoefficientCache::Key &key, size_t rampLength, DesignFunction &&design);
+
+  /**
+   * @brief Decide which chain runs the stage and hand its sections over
+  */
+  void updateStage(size_t stage, const BasicCutCoefficients<double> &sections, size_t numSections, size_t rampLength) noexcept;
+
+  bool runsInDoublePrecision(size_t stage, const BasicSectionCoefficients<double> *sections, size_t numSections) const noexcept;
+
+  /**
+   * @brief Redesign the stages whose version differs from the applied one
+  */
+  void applyChainSettings(const ChainSettings &chainSettings, const ChainVersions &versions, 
+                          ChainVersions &applied, size_t rampLength);
+
+  bool isSmoothingEnabled() const noexcept;
+
+  /**
+   * @brief Clear the filter state and make both the stepped and the smoothing path redesign every stage
+  */
+  void resetFilterDesign() noexcept;
+
+  /**
+   * @brief Switch the oversampling factor on the audio thread, everything it needs was allocated in prepareToPlay
+  */
+  void setOversampling(int index) noexcept;
+
+  template <typename SampleType>
+  void processBlockInPrecision(juce::AudioBuffer<SampleType> &buffer);
+
+  template <typename SampleType>
+  juce::dsp::Oversampling<SampleType> *getOversampler(int index) noexcept;
+
+  /**
+   * @brief Run the filters on the block, at whatever rate the block has after oversampling
+  */
+  template <typename SampleType>
+  void processChain(juce::dsp::AudioBlock<SampleType> &block);
+
+  /**
+   * @brief Run both chains, the double stages first
+  */
+  template <typename SampleType>
+  void processStages(juce::dsp::AudioBlock<SampleType> &block) noexcept;
+
+  /**
+   * @brief Follow the parameters with the state variable chain of the block's precision and run it
+  */
+  template <typename SampleType>
+  void processStateVariable(juce::dsp::AudioBlock<SampleType> &block) noexcept;
+
+  template <typename SampleType>
+  void processLinearPhase(juce::dsp::AudioBlock<SampleType> &block) noexcept;
+
+  /**
+   * @brief Load the precomputed coefficients of the requested program and start the crossfade, called on the audio thread
+  */
+  void switchProgram() noexcept;
+
+  /**
+   * @brief Run the outgoing program on the input and fade from it to the already processed block
+  */
+  template <typename SampleType>
+  void processFade(juce::dsp::AudioBlock<SampleType> &block, juce::dsp::AudioBlock<SampleType> &outgoing) noexcept;
+
+  /**
+   * @brief Report the latency of the selected mode, called by prepareToPlay and on the message thread whenever
+   * the oversampling or linear-phase choice changes
+  */
+  void updateLatency();
+
+  /**
+   * @brief Tail of the given settings in the selected mode, including the latency of the mode
+  */
+  double getTailLengthSeconds(const ChainSettings &chainSettings) const noexcept;
+
+  void updateTailLength() noexcept;
+
+  /**
+   * @brief True if every input channel of the buffer is below silenceThreshold
+  */
+  template <typename SampleType>
+  bool isSilent(const juce::AudioBuffer<SampleType> &buffer) const noexcept;
+
+  /**
+   * @brief Clear the state of everything that rings, called when processing stops after the tail
+  */
+  void flushState() noexcept;
+
+  void parameterValueChanged(int parameterIndex, float newValue) override;
+  void parameterGestureChanged(int, bool) override {}
+
+  /**
+   * @brief Process the block on the smoothing grid, ramping the coefficients between grid points
+  */
+  template <typename SampleType>
+  void processSmoothed(juce::dsp::AudioBlock<SampleType> &block);
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimpleEQAudioProcessor)
 };
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include "SimpleEQ/BandLayout.h"
+
+#include <array>
+#include <vector>
+
+namespace audio_plugin {
+
+struct ChainSettings;
+
+/**
+ * @brief The factory programs, with the coefficients of every stage designed ahead of time
+ *
+ * The settings are rounded to the resolution of the parameters when the bank is built, so they compare equal
+ * to the parameters after a program was loaded. prepare() designs every program for every oversampling factor,
+ * switching programs on the audio thread then only copies finished coefficients into the chain.
+ * The bank is only modified by prepare(), while the audio thread is not running.
+*/
+class PresetBank {
+public:
+  /**
+   * @brief Raw double precision coefficients of every stage of the chain and the number of sections each stage uses
+  */
+  struct Stages {
+    std::array<std::array<std::array<double, 6>, 4>, maxBands> sections {};
+    std::array<size_t, maxBands> numSections {};
+  };
+
+  /**
+   * @brief Number of oversampling choices, the index is the base 2 logarithm of the factor
+  */
+  static constexpr int numOversamplingFactors = 3;
+
+  explicit PresetBank(juce::AudioProcessorValueTreeState &apvts);
+  ~PresetBank();
+
+  int getNumPrograms() const noexcept { return static_cast<int>(programs.size()); }
+
+  const juce::String &getName(int program) const;
+  const ChainSettings &getSettings(int program) const;
+
+  /**
+   * @brief Design every program for every oversampling factor at the host's sample rate, allocates
+  */
+  void prepare(double sampleRate);
+
+  /**
+   * @brief The coefficients of a program, safe to call on the audio thread after prepare()
+  */
+  const Stages &getStages(int program, int oversampling) const noexcept;
+
+private:
+  struct Program;
+  std::vector<Program> programs;
+  std::vector<Stages> stages;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetBank)
+};
+
+} // namespace audio_plugin
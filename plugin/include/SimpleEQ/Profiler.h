@@ -0,0 +1,232 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+// set by the SIMPLEEQ_PROFILING option in plugin/CMakeLists.txt, builds without it keep the counters
+#ifndef SIMPLEEQ_PROFILING
+ #define SIMPLEEQ_PROFILING 1
+#endif
+
+namespace audio_plugin {
+
+/**
+ * @brief Lock-free histogram of durations with one writer and any number of readers
+ *
+ * The buckets are spaced logarithmically, four per octave from 1 ns to about 16 ms, longer durations land
+ * in the last one. The writer only increments counters and never resets them, a reader takes snapshots
+ * and looks at the difference of two of them, e.g. the last second.
+*/
+class DurationHistogram {
+public:
+  static constexpr size_t bucketsPerOctave = 4;
+  static constexpr size_t numOctaves = 24;
+  static constexpr size_t numBuckets = bucketsPerOctave * numOctaves;
+
+  using Counts = std::array<juce::uint32, numBuckets>;
+
+  /**
+   * @brief Count one duration, only ever called by the one writer
+  */
+  void record(juce::uint64 nanoseconds) noexcept
+  {
+    // a plain increment, there is no other writer to race with
+    auto &count = counts[getBucket(nanoseconds)];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  Counts getSnapshot() const noexcept;
+
+  static size_t getBucket(juce::uint64 nanoseconds) noexcept;
+
+  /**
+   * @brief The shortest duration that falls into the bucket
+  */
+  static double getBucketStart(size_t bucket) noexcept;
+
+  /**
+   * @brief The counts recorded between two snapshots, the counters may have wrapped around in between
+  */
+  static Counts getDifference(const Counts &later, const Counts &earlier) noexcept;
+
+  /**
+   * @brief Upper edge of the bucket that contains the given fraction of the counts, in nanoseconds
+   * @return 0 if nothing was counted
+  */
+  static double getPercentile(const Counts &counts, double fraction) noexcept;
+
+private:
+  std::array<std::atomic<juce::uint32>, numBuckets> counts {};
+};
+
+/**
+ * @brief Always-on timings of processBlock, one histogram per section of the block
+ *
+ * The audio thread collects the durations of a block with beginBlock(), add() and endBlock(), which
+ * only read the high resolution clock and add up integers, and records them when the block ends.
+ *
+ * The biquad chain fuses its stages into shared passes over the samples, so there is no time per stage
+ * that could be measured without unfusing it. Filters covers the whole filter engine of every block.
+ *
+ * While a trace is attached, every block is also pushed into a wait-free FIFO, see ProfileTraceWriter.
+ * With SIMPLEEQ_PROFILING set to 0 all of it compiles to nothing.
+*/
+class Profiler {
+public:
+  static constexpr bool isEnabled = SIMPLEEQ_PROFILING != 0;
+
+  enum Section {
+    Block,
+    Coefficients,
+    Filters,
+    numSections
+  };
+
+  static constexpr std::array<const char *, numSections> sectionNames {
+    "Block", "Coefficients", "Filters"
+  };
+
+  using Ticks = juce::int64;
+
+  Profiler() noexcept;
+
+  /**
+   * @brief What the trace gets of every block, the durations are in ticks
+  */
+  struct BlockRecord {
+    Ticks start {0};
+    int numSamples {0};
+    std::array<Ticks, numSections> durations {};
+  };
+
+  static Ticks now() noexcept
+  {
+    if constexpr (isEnabled) {
+      return juce::Time::getHighResolutionTicks();
+    } else {
+      return 0;
+    }
+  }
+
+  double ticksToNanoseconds(Ticks ticks) const noexcept { return static_cast<double>(ticks) * nanosecondsPerTick; }
+
+  void beginBlock(int numSamples) noexcept
+  {
+    if constexpr (isEnabled) {
+      current = {now(), numSamples, {}};
+    }
+  }
+
+  void add(Section section, Ticks duration) noexcept
+  {
+    if constexpr (isEnabled) {
+      current.durations[section] += duration;
+    }
+  }
+
+  void endBlock() noexcept
+  {
+    if constexpr (isEnabled) {
+      finishBlock();
+    }
+  }
+
+  /**
+   * @brief Adds the duration of its scope to a section of the current block
+  */
+  class ScopedSection {
+  public:
+    ScopedSection(Profiler &p, Section s) noexcept : profiler(p), section(s), start(now()) {}
+    ~ScopedSection() { profiler.add(section, now() - start); }
+
+  private:
+    Profiler &profiler;
+    Section section;
+    Ticks start;
+
+    JUCE_DECLARE_NON_COPYABLE(ScopedSection)
+  };
+
+  const DurationHistogram &getHistogram(Section section) const noexcept { return histograms[section]; }
+
+  /**
+   * @brief Number of blocks recorded so far
+  */
+  juce::uint64 getNumBlocks() const noexcept { return numBlocks.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Push every block into the trace FIFO from now on, or stop
+  */
+  void setTracing(bool shouldTrace) noexcept { tracing.store(shouldTrace, std::memory_order_release); }
+
+  /**
+   * @brief Move up to maxRecords blocks out of the trace FIFO, only called by the one consumer
+   * @return The number of records read
+  */
+  int pullTrace(BlockRecord *destination, int maxRecords) noexcept;
+
+  /**
+   * @brief Blocks that didn't fit into the trace FIFO because the consumer fell behind
+  */
+  juce::uint64 getNumDroppedTraceRecords() const noexcept { return droppedTraceRecords.load(std::memory_order_relaxed); }
+
+private:
+  static constexpr int traceCapacity = 1 << 10;
+
+  // the tick rate is read once, a function-local static would test its guard on every block
+  double nanosecondsPerTick;
+
+  BlockRecord current;
+
+  std::array<DurationHistogram, numSections> histograms;
+  std::atomic<juce::uint64> numBlocks {0};
+
+  std::atomic<bool> tracing {false};
+  std::atomic<juce::uint64> droppedTraceRecords {0};
+
+  // AbstractFifo keeps one slot free to tell a full buffer from an empty one
+  juce::AbstractFifo traceFifo {traceCapacity + 1};
+  std::array<BlockRecord, traceCapacity + 1> traceRecords {};
+
+  void finishBlock() noexcept;
+};
+
+/**
+ * @brief Writes the blocks of a Profiler into a trace file that chrome://tracing and Perfetto open
+ *
+ * Every block becomes a complete event on the audio track and a counter sample with the microseconds
+ * of each section. A background thread drains the profiler a few times per second and appends to the
+ * file, the JSON array is closed when the writer is destroyed.
+*/
+class ProfileTraceWriter : private juce::Thread {
+public:
+  ProfileTraceWriter(Profiler &, const juce::File &);
+  ~ProfileTraceWriter() override;
+
+  /**
+   * @brief Environment variable with the path of the trace file the standalone target writes
+  */
+  static constexpr const char *environmentVariable = "SIMPLEEQ_TRACE_FILE";
+
+  bool isWriting() const noexcept { return stream != nullptr; }
+
+private:
+  static constexpr int drainIntervalMilliseconds = 100;
+
+  Profiler &profiler;
+  std::unique_ptr<juce::FileOutputStream> stream;
+  std::array<Profiler::BlockRecord, 256> records {};
+  Profiler::Ticks origin;
+  bool firstEvent {true};
+
+  void run() override;
+  void drain();
+  void writeEvent(const juce::String &json);
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfileTraceWriter)
+};
+
+} // namespace audio_plugin
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "SimpleEQ/PluginProcessor.h"
+
+#include <array>
+#include <vector>
+
+namespace audio_plugin {
+
+/**
+ * @brief Magnitude response of the chain, evaluated on a log-frequency grid
+ *
+ * The grid, stored as the real and imaginary parts of z^-1 and z^-2 for every point, only changes
+ * when the number of points or the sample rate changes. Besides the log-frequency grid of the editor
+ * any set of frequencies can be evaluated. Every stage keeps its own squared magnitude,
+ * which is only reevaluated when the coefficients of that stage are replaced. All arrays are laid out
+ * as structure of arrays so the evaluation loops vectorize.
+*/
+class ResponseCurve {
+public:
+  static constexpr double minFrequency = 20.0;
+  static constexpr double maxFrequency = 20000.0;
+  static constexpr size_t numStages = maxBands;
+
+  /**
+   * @brief Rebuild the log-frequency grid between minFrequency and maxFrequency if the number of points or the sample rate changed
+  */
+  void prepare(int numPoints, double sampleRate);
+
+  /**
+   * @brief Evaluate the response at arbitrary frequencies, e.g. the bins of an FFT
+  */
+  void prepare(const std::vector<double> &frequencies, double sampleRate);
+
+  /**
+   * @brief Replace the sections of a stage and reevaluate its magnitude
+   * @param stage The position of the stage in the chain, a ChainPositions value or the position of an extra band
+   * @param sections The raw coefficients of the active sections
+   * @param numSections The number of active sections, stages without sections don't contribute
+  */
+  void setStage(size_t stage, const SectionCoefficients *sections, size_t numSections);
+
+  /**
+   * @brief The squared magnitude of the whole chain, one value per point
+  */
+  const std::vector<double> &getPower();
+
+  /**
+   * @brief The magnitude of the whole chain in decibels, one value per point
+  */
+  const std::vector<double> &getMagnitudesInDecibels();
+
+  int getNumPoints() const { return static_cast<int>(decibels.size()); }
+
+private:
+  /**
+   * @brief Normalised section coefficients in double precision
+  */
+  struct Section {
+    double b0, b1, b2, a1, a2;
+  };
+
+  struct Stage {
+    std::vector<Section> sections;
+    std::vector<double> power;
+  };
+
+  double currentSampleRate {0.0};
+
+  // cos(w), cos(2w), sin(w) and sin(2w) of every point
+  std::vector<double> cos1, cos2, sin1, sin2;
+
+  std::array<Stage, numStages> stages;
+  std::vector<double> power, decibels;
+  bool powerIsValid {false}, decibelsAreValid {false};
+
+  void evaluateStage(Stage &stage);
+};
+
+} // namespace audio_plugin
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "SimpleEQ/PluginProcessor.h"
+#include "SimpleEQ/ResponseCurve.h"
+
+#include <array>
+#include <atomic>
+
+namespace audio_plugin {
+
+/**
+ * @brief Computes and rasterizes the response curve on a background thread
+ *
+ * The curve is drawn into transparent frames that are handed to the message thread without locks.
+ * There are three frame slots: the renderer owns one, paint() owns one, and the third holds the
+ * most recently published frame. Publishing and acquiring are single atomic exchanges of slot
+ * indices, so neither side ever touches the image the other one is using.
+*/
+class ResponseCurveRenderer : private juce::Thread {
+public:
+  explicit ResponseCurveRenderer(SimpleEQAudioProcessor &);
+  ~ResponseCurveRenderer() override;
+
+  void start();
+
+  /**
+   * @brief Set the size of the frames, called from the message thread
+  */
+  void setSize(int width, int height);
+
+  /**
+   * @brief Ask for a new frame, several requests before the renderer wakes up result in one frame
+  */
+  void requestUpdate()
+  {
+    requests.fetch_add(1, std::memory_order_release);
+    notify();
+  }
+
+  /**
+   * @brief True while a requested frame hasn't been published yet
+  */
+  bool isUpdatePending() const noexcept
+  {
+    return completedRequests.load(std::memory_order_acquire) != requests.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief True if a frame was published that has not been acquired yet
+  */
+  bool isFrameReady() const noexcept { return (readySlot.load(std::memory_order_acquire) & newFrameFlag) != 0; }
+
+  /**
+   * @brief The most recent finished frame, only call this from the message thread
+  */
+  const juce::Image &acquireFrame() noexcept;
+
+private:
+  static constexpr int slotMask = 3;
+  static constexpr int newFrameFlag = 4;
+
+  SimpleEQAudioProcessor &processorRef;
+
+  std::atomic<int> width {0}, height {0};
+
+  std::array<juce::Image, 3> frames;
+  std::atomic<int> readySlot {1};
+  int backSlot {0};
+  int frontSlot {2};
+
+  // requests made so far and the last one a published frame covers, they differ while a frame is pending
+  std::atomic<juce::uint32> requests {0};
+  std::atomic<juce::uint32> completedRequests {0};
+
+  // only used by the render thread
+  ResponseCurve responseCurve;
+  ChainSettingsTracker settingsTracker;
+  ChainVersions appliedVersions;
+  double curveSampleRate {0.0};
+  juce::Path curvePath;
+
+  void run() override;
+
+  /**
+   * @brief Redesign the stages whose parameters changed and update their part of the curve
+  */
+  void updateResponseCurve(int numPoints);
+
+  void renderFrame();
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ResponseCurveRenderer)
+};
+
+} // namespace audio_plugin
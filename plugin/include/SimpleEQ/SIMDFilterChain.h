@@ -0,0 +1,566 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include "SimpleEQ/Biquad.h"
+
+#include <array>
+#include <vector>
+
+namespace audio_plugin {
+
+JUCE_BEGIN_IGNORE_WARNINGS_MSVC(4324) // structure was padded due to alignment specifier
+
+/**
+ * @brief Filter chain of up to maxStages bands that processes any number of channels in groups of numLanes() channels
+ *
+ * Every stage (a band, e.g. LowCut, Peak, HighCut) owns up to maxSectionsPerStage second order sections.
+ * The coefficients of all sections are shared by every channel and stored as structure of arrays, each
+ * group of channels owns the state of all sections, also as structure of arrays, so one vectorized pass
+ * filters all channels of the group.
+ *
+ * Only the sections of stages that actually change the signal are processed. They are collected into a
+ * compact list whenever a stage changes, stages without sections and stages whose sections are all
+ * flat, e.g. a peak at 0 dB, cost nothing at processing time. The list is run in fused passes of up to
+ * maxFusedSections sections, each sample passes all sections of a pass while it is still in a register.
+ *
+ * Coefficient changes can optionally be ramped, the coefficients then move linearly towards the new
+ * values over the given number of samples.
+ *
+ * A mono block would leave all lanes but the first idle and wait on the latency of one section after the
+ * other. Unless it is ramping, it is pipelined across the sections instead: lane j runs section j of a pass
+ * on sample n - j, so up to numLanes() sections advance with every vector operation. Every lane still does
+ * exactly the operations of the scalar filter, the output stays bit-exact.
+*/
+template <typename SampleType>
+class SIMDFilterChain {
+public:
+  using Vector = SIMDVector<SampleType>;
+  using RawCoefficients = std::array<SampleType, 6>;
+
+  static constexpr size_t lanes = numLanes<SampleType>();
+  static constexpr size_t maxStages = 16;
+
+  /**
+   * @brief 48 dB/Oct needs four second order sections
+  */
+  static constexpr size_t maxSectionsPerStage = 4;
+  static constexpr size_t maxSections = maxStages * maxSectionsPerStage;
+
+  /**
+   * @brief Number of sections that share one pass over the block, more would no longer fit into the registers
+  */
+  static constexpr size_t maxFusedSections = 4;
+
+  /**
+   * @brief Allocate the channel groups and the interleaved scratch buffer and clear the filter state
+  */
+  void prepare(const juce::dsp::ProcessSpec &spec)
+  {
+    numChannels = static_cast<size_t>(spec.numChannels);
+
+    groups.resize((numChannels + lanes - 1) / lanes);
+    interleaved.assign(static_cast<size_t>(spec.maximumBlockSize), Vector {});
+
+    reset();
+  }
+
+  void reset() noexcept
+  {
+    for (auto &group : groups) {
+      group.s1.fill(Vector {});
+      group.s2.fill(Vector {});
+    }
+
+    // land exactly on the targets instead of accumulating the rounding errors of the increments
+    current = targets;
+    increments = {};
+    rampRemaining.fill(0);
+
+    updateActiveSections();
+  }
+
+  /**
+   * @brief Set the coefficients of a stage, sections beyond numSections are bypassed but keep their state
+   * @param stage The index of the stage in the chain
+   * @param sections The raw coefficients of the sections
+   * @param numSections The number of active sections
+   * @param rampLength Number of samples over which the coefficients are interpolated, 0 switches immediately
+  */
+  void setStage(size_t stage, const RawCoefficients *sections, size_t numSections, size_t rampLength = 0) noexcept
+  {
+    jassert(stage < maxStages && numSections <= maxSectionsPerStage);
+
+    for (size_t i = 0; i < numSections; i++) {
+      const auto section = stage * maxSectionsPerStage + i;
+      const auto target = BiquadCoefficients<SampleType>::fromRaw(sections[i]);
+      targets.set(section, target);
+
+      // sections that were just switched on have no meaningful coefficients to ramp from
+      if (rampLength > 0 && i < stageSizes[stage]) {
+        increments.set(section, getCoefficientIncrement(current.get(section), target, rampLength));
+        rampRemaining[section] = rampLength;
+      } else {
+        current.set(section, target);
+        increments.set(section, {0, 0, 0, 0, 0});
+        rampRemaining[section] = 0;
+      }
+    }
+    stageSizes[stage] = numSections;
+
+    updateActiveSections();
+  }
+
+  /**
+   * @brief Number of sections that are currently processed, bypassed and flat stages don't count
+  */
+  size_t getNumActiveSections() const noexcept { return numActive; }
+
+  size_t getNumChannels() const noexcept { return numChannels; }
+
+  /**
+   * @brief Whether mono blocks are pipelined across the sections, on by default
+  */
+  void setPipelining(bool shouldPipeline) noexcept { pipelining = shouldPipeline; }
+
+  /**
+   * @brief State {s1, s2} of one section of one channel, e.g. to hand a stage over to a chain of another precision
+  */
+  std::array<SampleType, 2> getSectionState(size_t channel, size_t stage, size_t section) const noexcept
+  {
+    const auto &group = groups[channel / lanes];
+    const auto index = stage * maxSectionsPerStage + section;
+    return {getLane(group.s1[index], channel % lanes), getLane(group.s2[index], channel % lanes)};
+  }
+
+  void setSectionState(size_t channel, size_t stage, size_t section, const std::array<SampleType, 2> &state) noexcept
+  {
+    auto &group = groups[channel / lanes];
+    const auto index = stage * maxSectionsPerStage + section;
+    setLane(group.s1[index], channel % lanes, state[0]);
+    setLane(group.s2[index], channel % lanes, state[1]);
+  }
+
+  void process(const juce::dsp::ProcessContextReplacing<SampleType> &context) noexcept
+  {
+    if (context.isBypassed || numPasses == 0) {
+      return;
+    }
+
+    auto &block = context.getOutputBlock();
+    jassert(block.getNumChannels() <= groups.size() * lanes);
+
+    const auto blockChannels = juce::jmin(block.getNumChannels(), groups.size() * lanes);
+    const auto capacity = interleaved.size();
+    const auto numSamples = block.getNumSamples();
+
+    if constexpr (lanes > 1) {
+      // ramps move the coefficients of every section on every sample, those blocks take the regular path
+      if (pipelining && blockChannels == 1 && !isRamping()) {
+        processPipelined(block.getChannelPointer(0), numSamples);
+        return;
+      }
+    }
+
+    for (size_t start = 0; start < numSamples && capacity > 0; start += capacity) {
+      const auto count = juce::jmin(capacity, numSamples - start);
+
+      for (size_t firstChannel = 0; firstChannel < blockChannels; firstChannel += lanes) {
+        const auto channels = juce::jmin(lanes, blockChannels - firstChannel);
+
+        // every group starts from the same coefficients, the last one stores where the ramps ended up
+        const auto isLastGroup = firstChannel + lanes >= blockChannels;
+
+        interleave(block, firstChannel, channels, start, count);
+        for (size_t pass = 0; pass < numPasses; pass++) {
+          (this->*passes[pass].function)(&activeSections[passes[pass].first], groups[firstChannel / lanes],
+                                         interleaved.data(), count, isLastGroup);
+        }
+        deinterleave(block, firstChannel, channels, start, count);
+      }
+
+      // a stage that ramped to flat coefficients can be skipped from now on
+      if (rampsFinished) {
+        rampsFinished = false;
+        updateActiveSections();
+      }
+    }
+  }
+
+private:
+  /**
+   * @brief Coefficients of every section, one array per coefficient
+  */
+  struct CoefficientArrays {
+    alignas(64) std::array<SampleType, maxSections> b0 {}, b1 {}, b2 {}, a1 {}, a2 {};
+
+    BiquadCoefficients<SampleType> get(size_t i) const noexcept { return {b0[i], b1[i], b2[i], a1[i], a2[i]}; }
+
+    void set(size_t i, const BiquadCoefficients<SampleType> &c) noexcept
+    {
+      b0[i] = c.b0;
+      b1[i] = c.b1;
+      b2[i] = c.b2;
+      a1[i] = c.a1;
+      a2[i] = c.a2;
+    }
+  };
+
+  /**
+   * @brief State of every section for one group of channels
+  */
+  struct GroupState {
+    alignas(64) std::array<Vector, maxSections> s1 {}, s2 {};
+  };
+
+  using PassFunction = void (SIMDFilterChain::*)(const juce::uint8 *, GroupState &, Vector *, size_t, bool) noexcept;
+
+  /**
+   * @brief A fused pass over the block, the specialization for its number of sections is selected when the list changes
+  */
+  struct Pass {
+    PassFunction function;
+    size_t first;
+  };
+
+  CoefficientArrays current, targets, increments;
+  std::array<size_t, maxSections> rampRemaining {};
+  std::array<size_t, maxStages> stageSizes {};
+  std::array<bool, maxStages> stageSkipped {};
+  bool rampsFinished {false};
+  bool pipelining {true};
+
+  std::array<juce::uint8, maxSections> activeSections {};
+  size_t numActive {0};
+  std::array<Pass, maxSections / maxFusedSections> passes {};
+  size_t numPasses {0};
+
+  size_t numChannels {0};
+  std::vector<GroupState> groups;
+  std::vector<Vector> interleaved;
+
+  static SampleType getLane(const Vector &v, size_t lane) noexcept
+  {
+    if constexpr (lanes == 1) {
+      juce::ignoreUnused(lane);
+      return static_cast<SampleType>(v);
+    } else {
+      return v.get(lane);
+    }
+  }
+
+  static void setLane(Vector &v, size_t lane, SampleType value) noexcept
+  {
+    if constexpr (lanes == 1) {
+      juce::ignoreUnused(lane);
+      v = value;
+    } else {
+      v.set(lane, value);
+    }
+  }
+
+  bool isRamping() const noexcept
+  {
+    for (size_t i = 0; i < numActive; i++) {
+      if (rampRemaining[activeSections[i]] > 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool isStageFlat(size_t stage) const noexcept
+  {
+    for (size_t i = 0; i < stageSizes[stage]; i++) {
+      const auto section = stage * maxSectionsPerStage + i;
+      if (rampRemaining[section] > 0 || !current.get(section).isIdentity()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Collect the sections that change the signal and plan the fused passes over them
+  */
+  void updateActiveSections() noexcept
+  {
+    numActive = 0;
+
+    for (size_t stage = 0; stage < maxStages; stage++) {
+      const auto skipped = isStageFlat(stage);
+
+      // a flat section leaves nothing but its own decay in the output, start from silence once it is needed again
+      if (skipped && !stageSkipped[stage]) {
+        for (auto &group : groups) {
+          for (size_t i = 0; i < stageSizes[stage]; i++) {
+            group.s1[stage * maxSectionsPerStage + i] = Vector {};
+            group.s2[stage * maxSectionsPerStage + i] = Vector {};
+          }
+        }
+      }
+      stageSkipped[stage] = skipped;
+
+      for (size_t i = 0; !skipped && i < stageSizes[stage]; i++) {
+        activeSections[numActive++] = static_cast<juce::uint8>(stage * maxSectionsPerStage + i);
+      }
+    }
+
+    static constexpr std::array<PassFunction, maxFusedSections + 1> passFunctions {
+      nullptr, &SIMDFilterChain::processPass<1>, &SIMDFilterChain::processPass<2>,
+      &SIMDFilterChain::processPass<3>, &SIMDFilterChain::processPass<4>
+    };
+
+    // dispatch happens here, when a stage changes, instead of once per pass and block
+    numPasses = 0;
+    for (size_t first = 0; first < numActive; first += maxFusedSections) {
+      passes[numPasses++] = {passFunctions[juce::jmin(maxFusedSections, numActive - first)], first};
+    }
+  }
+
+  template <size_t NumSections>
+  static void processFused(std::array<BiquadCoefficients<SampleType>, NumSections> &coefficients,
+                           std::array<BiquadState<Vector>, NumSections> &state,
+                           Vector *data, size_t count) noexcept
+  {
+    for (size_t i = 0; i < count; i++) {
+      auto sample = data[i];
+      for (size_t s = 0; s < NumSections; s++) {
+        sample = processBiquad(coefficients[s], state[s], sample);
+      }
+      data[i] = sample;
+    }
+  }
+
+  template <size_t NumSections>
+  static void processFusedRamped(std::array<BiquadCoefficients<SampleType>, NumSections> &coefficients,
+                                 const std::array<BiquadCoefficients<SampleType>, NumSections> &increment,
+                                 std::array<BiquadState<Vector>, NumSections> &state,
+                                 Vector *data, size_t count) noexcept
+  {
+    for (size_t i = 0; i < count; i++) {
+      auto sample = data[i];
+      for (size_t s = 0; s < NumSections; s++) {
+        advanceCoefficients(coefficients[s], increment[s]);
+        sample = processBiquad(coefficients[s], state[s], sample);
+      }
+      data[i] = sample;
+    }
+  }
+
+  /**
+   * @brief Run count vectors through the given sections, splitting the block where ramps end
+   * @param storeCoefficients Whether the ramped coefficients are written back, only for the last group
+  */
+  template <size_t NumSections>
+  void processPass(const juce::uint8 *sections, GroupState &group, Vector *data, size_t count, bool storeCoefficients) noexcept
+  {
+    // keep the whole pass in locals so the compiler can hold it in registers
+    std::array<BiquadCoefficients<SampleType>, NumSections> coefficients, increment;
+    std::array<BiquadState<Vector>, NumSections> state;
+    std::array<size_t, NumSections> remaining;
+
+    for (size_t s = 0; s < NumSections; s++) {
+      coefficients[s] = current.get(sections[s]);
+      increment[s] = increments.get(sections[s]);
+      state[s] = {group.s1[sections[s]], group.s2[sections[s]]};
+      remaining[s] = rampRemaining[sections[s]];
+    }
+
+    for (size_t done = 0; done < count;) {
+      auto segment = count - done;
+      auto ramping = false;
+      for (size_t s = 0; s < NumSections; s++) {
+        if (remaining[s] > 0) {
+          segment = juce::jmin(segment, remaining[s]);
+          ramping = true;
+        }
+      }
+
+      if (!ramping) {
+        processFused<NumSections>(coefficients, state, data + done, segment);
+        break;
+      }
+
+      // sections that aren't ramping have zero increments and keep their coefficients
+      processFusedRamped<NumSections>(coefficients, increment, state, data + done, segment);
+      done += segment;
+
+      for (size_t s = 0; s < NumSections; s++) {
+        if (remaining[s] > 0) {
+          remaining[s] -= segment;
+          if (remaining[s] == 0) {
+            coefficients[s] = targets.get(sections[s]);
+            increment[s] = {0, 0, 0, 0, 0};
+          }
+        }
+      }
+    }
+
+    for (size_t s = 0; s < NumSections; s++) {
+      snapLanesToZero(state[s].s1);
+      snapLanesToZero(state[s].s2);
+      group.s1[sections[s]] = state[s].s1;
+      group.s2[sections[s]] = state[s].s2;
+    }
+
+    if (storeCoefficients) {
+      for (size_t s = 0; s < NumSections; s++) {
+        if (remaining[s] != rampRemaining[sections[s]]) {
+          rampsFinished = rampsFinished || remaining[s] == 0;
+          current.set(sections[s], coefficients[s]);
+          increments.set(sections[s], increment[s]);
+          rampRemaining[sections[s]] = remaining[s];
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Run a mono block through the active sections, numLanes() sections at a time
+   * The state of the channel is lane 0 of the first group, like on the regular path, so both can take turns.
+  */
+  void processPipelined(SampleType *data, size_t count) noexcept
+  {
+    auto &group = groups.front();
+
+    for (size_t first = 0; first < numActive; first += lanes) {
+      const auto numSections = juce::jmin(lanes, numActive - first);
+      if (numSections == 1) {
+        processScalar(activeSections[first], group, data, count);
+      } else {
+        processPipelinedPass(&activeSections[first], numSections, group, data, count);
+      }
+    }
+  }
+
+  void processScalar(size_t section, GroupState &group, SampleType *data, size_t count) noexcept
+  {
+    const auto coefficients = current.get(section);
+    BiquadState<SampleType> state {getLane(group.s1[section], 0), getLane(group.s2[section], 0)};
+
+    for (size_t i = 0; i < count; i++) {
+      data[i] = processBiquad(coefficients, state, data[i]);
+    }
+
+    juce::dsp::util::snapToZero(state.s1);
+    juce::dsp::util::snapToZero(state.s2);
+    setLane(group.s1[section], 0, state.s1);
+    setLane(group.s2[section], 0, state.s2);
+  }
+
+  /**
+   * @brief Pipeline the block through up to numLanes() sections
+   *
+   * At step t lane j processes sample t - j, its input is the output of lane j - 1 from the previous step.
+   * The first and the last numSections - 1 steps have lanes without a sample, they run lane by lane
+   * on scalars, everything in between is one vector section per step. Spare lanes are identity sections.
+  */
+  void processPipelinedPass(const juce::uint8 *sections, size_t numSections, GroupState &group,
+                            SampleType *data, size_t count) noexcept
+  {
+    struct LaneCoefficients {
+      Vector b0, b1, b2, a1, a2;
+    };
+
+    std::array<BiquadCoefficients<SampleType>, lanes> coefficients {};
+    std::array<BiquadState<SampleType>, lanes> state {};
+    std::array<SampleType, lanes> outputs {};
+
+    for (size_t j = 0; j < numSections; j++) {
+      coefficients[j] = current.get(sections[j]);
+      state[j] = {getLane(group.s1[sections[j]], 0), getLane(group.s2[sections[j]], 0)};
+    }
+
+    const auto last = numSections - 1;
+
+    auto scalarStep = [&](size_t t) {
+      // from the last lane down, every lane still needs the output of the one below from the previous step
+      const auto lowest = t >= count ? t - count + 1 : 0;
+      for (auto j = juce::jmin(t, last) + 1; j-- > lowest;) {
+        outputs[j] = processBiquad(coefficients[j], state[j], j == 0 ? data[t] : outputs[j - 1]);
+      }
+      if (t >= last) {
+        data[t - last] = outputs[last];
+      }
+    };
+
+    const auto tailStart = juce::jmax(count, last);
+    for (size_t t = 0; t < last; t++) {
+      scalarStep(t);
+    }
+
+    if (last < count) {
+      LaneCoefficients laneCoefficients {};
+      BiquadState<Vector> laneState {};
+      Vector pipe {};
+
+      for (size_t j = 0; j < lanes; j++) {
+        setLane(laneCoefficients.b0, j, coefficients[j].b0);
+        setLane(laneCoefficients.b1, j, coefficients[j].b1);
+        setLane(laneCoefficients.b2, j, coefficients[j].b2);
+        setLane(laneCoefficients.a1, j, coefficients[j].a1);
+        setLane(laneCoefficients.a2, j, coefficients[j].a2);
+        setLane(laneState.s1, j, state[j].s1);
+        setLane(laneState.s2, j, state[j].s2);
+        setLane(pipe, j, outputs[j]);
+      }
+
+      for (size_t t = last; t < count; t++) {
+        pipe = processBiquad(laneCoefficients, laneState, shiftLanesUp(pipe, data[t]));
+        data[t - last] = getLane(pipe, last);
+      }
+
+      for (size_t j = 0; j < numSections; j++) {
+        state[j] = {getLane(laneState.s1, j), getLane(laneState.s2, j)};
+        outputs[j] = getLane(pipe, j);
+      }
+    }
+
+    for (size_t t = tailStart; t < count + last; t++) {
+      scalarStep(t);
+    }
+
+    for (size_t j = 0; j < numSections; j++) {
+      juce::dsp::util::snapToZero(state[j].s1);
+      juce::dsp::util::snapToZero(state[j].s2);
+      setLane(group.s1[sections[j]], 0, state[j].s1);
+      setLane(group.s2[sections[j]], 0, state[j].s2);
+    }
+  }
+
+  SampleType *rawInterleaved() noexcept { return reinterpret_cast<SampleType *>(interleaved.data()); }
+
+  void interleave(const juce::dsp::AudioBlock<SampleType> &block, size_t firstChannel, size_t channels, size_t start, size_t count) noexcept
+  {
+    auto *raw = rawInterleaved();
+    for (size_t lane = 0; lane < channels; lane++) {
+      const auto *src = block.getChannelPointer(firstChannel + lane) + start;
+      for (size_t i = 0; i < count; i++) {
+        raw[i * lanes + lane] = src[i];
+      }
+    }
+
+    // the unused lanes of the last group must not carry over samples of another group
+    for (size_t lane = channels; lane < lanes; lane++) {
+      for (size_t i = 0; i < count; i++) {
+        raw[i * lanes + lane] = SampleType(0);
+      }
+    }
+  }
+
+  void deinterleave(const juce::dsp::AudioBlock<SampleType> &block, size_t firstChannel, size_t channels, size_t start, size_t count) noexcept
+  {
+    const auto *raw = rawInterleaved();
+    for (size_t lane = 0; lane < channels; lane++) {
+      auto *dst = block.getChannelPointer(firstChannel + lane) + start;
+      for (size_t i = 0; i < count; i++) {
+        dst[i] = raw[i * lanes + lane];
+      }
+    }
+  }
+};
+
+JUCE_END_IGNORE_WARNINGS_MSVC
+
+} // namespace audio_plugin
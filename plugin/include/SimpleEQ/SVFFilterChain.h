@@ -0,0 +1,392 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include "SimpleEQ/FilterDesigner.h"
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace audio_plugin {
+
+/**
+ * @brief tan(x) for 0 <= x < pi / 2 from a rational approximation, no library call
+ * Above pi / 4 it uses tan(x) = 1 / tan(pi / 2 - x), so the Pade approximant only ever sees |x| <= pi / 4,
+ * where its relative error stays below 1e-12.
+*/
+template <typename SampleType>
+inline SampleType approximateTan(SampleType x) noexcept
+{
+  constexpr auto quarterPi = juce::MathConstants<SampleType>::pi / SampleType(4);
+  constexpr auto halfPi = juce::MathConstants<SampleType>::halfPi;
+
+  auto pade = [](SampleType y) {
+    const auto y2 = y * y;
+    return y * (SampleType(135135) + y2 * (SampleType(-17325) + y2 * (SampleType(378) - y2)))
+             / (SampleType(135135) + y2 * (SampleType(-62370) + y2 * (SampleType(3150) - SampleType(28) * y2)));
+  };
+
+  return x > quarterPi ? SampleType(1) / pade(halfPi - x) : pade(x);
+}
+
+/**
+ * @brief Filter chain of topology-preserving state variable filters, an alternative to the biquads of SIMDFilterChain
+ *
+ * Every stage is described by its response, frequency, quality and gain instead of by coefficients. The trapezoidal
+ * SVF (A. Simper, "Linear Trap Optimised SVF") stays well behaved when those change on every sample, its state
+ * are the integrator outputs, not past samples of a particular response. A stage that is moved with a ramp
+ * recomputes its sections on every sample: one approximateTan() for the shared cutoff plus a few multiplies and
+ * two divisions per section, cheap enough for audio-rate modulation. The frequency and the gain move
+ * exponentially, the quality linearly, like the ChainSmoother.
+ *
+ * The responses are the ones of the biquad designs: peak, shelves and notch match the RBJ designs and the cuts the
+ * Butterworth cascades of filter_design, up to rounding. Stages that are off or flat cost nothing.
+*/
+template <typename SampleType>
+class SVFFilterChain {
+public:
+  /**
+   * @brief Response of a stage, one or more sections sharing the cutoff
+  */
+  enum class Response {
+    Off,
+    Peak,
+    LowShelf,
+    HighShelf,
+    Notch,
+    HighPass,
+    LowPass
+  };
+
+  struct StageSettings {
+    Response response {Response::Off};
+
+    /**
+     * @brief Even Butterworth order of a HighPass or LowPass cascade, 0 for a single section of the given quality
+    */
+    int butterworthOrder {0};
+
+    double freq {1000.0}, quality {1.0}, gainInDecibels {0.0};
+
+    bool operator==(const StageSettings &) const = default;
+  };
+
+  static constexpr size_t maxStages = 16;
+
+  /**
+   * @brief 48 dB/Oct needs four second order sections
+  */
+  static constexpr size_t maxSectionsPerStage = filter_design::getNumButterworthSections(filter_design::maxButterworthOrder);
+
+  void prepare(const juce::dsp::ProcessSpec &spec)
+  {
+    numChannels = static_cast<size_t>(spec.numChannels);
+    states.resize(numChannels);
+    reset();
+  }
+
+  /**
+   * @brief Clear the state and finish all ramps at their targets
+  */
+  void reset() noexcept
+  {
+    for (auto &channel : states) {
+      channel.fill({});
+    }
+
+    for (auto &stage : stages) {
+      stage.controls = stage.targetControls;
+      stage.rampRemaining = 0;
+      updateSections(stage);
+    }
+  }
+
+  /**
+   * @brief Set a stage, the frequency, quality and gain move there over rampLength samples
+   * A stage whose response, order or sample rate changes switches immediately, new sections start from silence.
+  */
+  void setStage(size_t stage, const StageSettings &settings, double sampleRate, size_t rampLength = 0) noexcept
+  {
+    jassert(stage < maxStages && sampleRate > 0.0);
+    auto &s = stages[stage];
+
+    if (settings == s.settings && sampleRate == s.sampleRate) {
+      return;
+    }
+
+    const auto target = getControls(settings, sampleRate);
+    const auto canRamp = rampLength > 0 && settings.response == s.settings.response
+                         && settings.butterworthOrder == s.settings.butterworthOrder && sampleRate == s.sampleRate;
+
+    const auto previousSections = s.numSections;
+    s.settings = settings;
+    s.sampleRate = sampleRate;
+    s.numSections = getNumSections(settings);
+    s.targetControls = target;
+
+    if (canRamp) {
+      const auto length = static_cast<SampleType>(rampLength);
+      s.increments = {static_cast<SampleType>(std::pow(target.omega / s.controls.omega, 1.0 / static_cast<double>(rampLength))),
+                      static_cast<SampleType>(std::pow(target.root / s.controls.root, 1.0 / static_cast<double>(rampLength))),
+                      (target.quality - s.controls.quality) / length};
+      s.rampRemaining = rampLength;
+    } else {
+      s.controls = target;
+      s.rampRemaining = 0;
+    }
+
+    for (auto &channel : states) {
+      for (size_t i = previousSections; i < s.numSections; i++) {
+        channel[stage * maxSectionsPerStage + i] = {};
+      }
+    }
+
+    updateSections(s);
+  }
+
+  size_t getNumChannels() const noexcept { return numChannels; }
+
+  void process(const juce::dsp::ProcessContextReplacing<SampleType> &context) noexcept
+  {
+    if (context.isBypassed) {
+      return;
+    }
+
+    auto &block = context.getOutputBlock();
+    jassert(block.getNumChannels() <= numChannels);
+
+    const auto channels = juce::jmin(block.getNumChannels(), numChannels);
+    const auto numSamples = block.getNumSamples();
+
+    // the stages are in series, so each one can run over the whole block before the next
+    for (size_t index = 0; index < maxStages; index++) {
+      auto &stage = stages[index];
+
+      // a flat stage leaves nothing but its own decay in the output, start from silence once it is needed again
+      if (isFlat(stage)) {
+        if (!stage.skipped) {
+          clearState(index);
+          stage.skipped = true;
+        }
+        continue;
+      }
+      stage.skipped = false;
+
+      size_t start = 0;
+      if (stage.rampRemaining > 0) {
+        start = juce::jmin(stage.rampRemaining, numSamples);
+        processRamp(stage, index, block, channels, start);
+      }
+      if (start < numSamples) {
+        processSteady(stage, index, block, channels, start, numSamples - start);
+      }
+
+      for (size_t ch = 0; ch < channels; ch++) {
+        for (size_t i = 0; i < stage.numSections; i++) {
+          auto &state = states[ch][index * maxSectionsPerStage + i];
+          juce::dsp::util::snapToZero(state.ic1);
+          juce::dsp::util::snapToZero(state.ic2);
+        }
+      }
+    }
+  }
+
+private:
+  /**
+   * @brief The values a ramp interpolates: pi f / fs, the fourth root of the linear gain and the quality
+  */
+  struct Controls {
+    SampleType omega {0}, root {1}, quality {1};
+  };
+
+  /**
+   * @brief Coefficients of one section, the gains a1 to a3 of the integrators and the mix m0 to m2 of input, band and low pass
+  */
+  struct Section {
+    SampleType a1 {1}, a2 {0}, a3 {0}, m0 {1}, m1 {0}, m2 {0};
+  };
+
+  struct SectionState {
+    SampleType ic1 {0}, ic2 {0};
+  };
+
+  struct Stage {
+    StageSettings settings;
+    double sampleRate {0.0};
+    size_t numSections {0};
+
+    Controls controls, targetControls;
+
+    /**
+     * @brief Per sample factors of omega and root and the per sample step of the quality
+    */
+    Controls increments;
+    size_t rampRemaining {0};
+    bool skipped {true};
+
+    std::array<Section, maxSectionsPerStage> sections {};
+  };
+
+  std::array<Stage, maxStages> stages {};
+
+  size_t numChannels {0};
+  std::vector<std::array<SectionState, maxStages * maxSectionsPerStage>> states;
+
+  static size_t getNumSections(const StageSettings &settings) noexcept
+  {
+    if (settings.response == Response::Off) {
+      return 0;
+    }
+    if (settings.butterworthOrder > 0) {
+      return filter_design::getNumButterworthSections(settings.butterworthOrder);
+    }
+    return 1;
+  }
+
+  static Controls getControls(const StageSettings &settings, double sampleRate) noexcept
+  {
+    // below Nyquist, the cutoff must not reach the pole of the tangent
+    const auto freq = juce::jlimit(2.0, 0.49 * sampleRate, settings.freq);
+    return {static_cast<SampleType>(juce::MathConstants<double>::pi * freq / sampleRate),
+            static_cast<SampleType>(std::pow(10.0, settings.gainInDecibels / 80.0)),
+            static_cast<SampleType>(juce::jmax(1.0e-3, settings.quality))};
+  }
+
+  static bool isFlat(const Stage &stage) noexcept
+  {
+    switch (stage.settings.response) {
+      case Response::Off:
+        return true;
+      case Response::Peak:
+      case Response::LowShelf:
+      case Response::HighShelf:
+        return stage.rampRemaining == 0 && stage.controls.root == SampleType(1);
+      case Response::Notch:
+      case Response::HighPass:
+      case Response::LowPass:
+        break;
+    }
+    return false;
+  }
+
+  static Section makeSection(SampleType g, SampleType k, SampleType m0, SampleType m1, SampleType m2) noexcept
+  {
+    const auto a1 = SampleType(1) / (SampleType(1) + g * (g + k));
+    const auto a2 = g * a1;
+    return {a1, a2, g * a2, m0, m1, m2};
+  }
+
+  /**
+   * @brief Compute the sections of the stage from its current controls
+  */
+  static void updateSections(Stage &stage) noexcept
+  {
+    const auto tanOmega = approximateTan(stage.controls.omega);
+    const auto root = stage.controls.root;
+    const auto a = root * root;
+    const auto k = SampleType(1) / stage.controls.quality;
+
+    switch (stage.settings.response) {
+      case Response::Peak: {
+        const auto bellK = k / a;
+        stage.sections[0] = makeSection(tanOmega, bellK, 1, bellK * (a * a - 1), 0);
+        break;
+      }
+      case Response::LowShelf:
+        stage.sections[0] = makeSection(tanOmega / root, k, 1, k * (a - 1), a * a - 1);
+        break;
+      case Response::HighShelf:
+        stage.sections[0] = makeSection(tanOmega * root, k, a * a, k * (1 - a) * a, 1 - a * a);
+        break;
+      case Response::Notch:
+        stage.sections[0] = makeSection(tanOmega, k, 1, -k, 0);
+        break;
+      case Response::HighPass:
+      case Response::LowPass: {
+        const auto highPass = stage.settings.response == Response::HighPass;
+        for (size_t i = 0; i < stage.numSections; i++) {
+          const auto damping = stage.settings.butterworthOrder > 0
+                             ? static_cast<SampleType>(filter_design::butterworthDampings[stage.numSections - 1][i])
+                             : k;
+          stage.sections[i] = highPass ? makeSection(tanOmega, damping, 1, -damping, -1)
+                                       : makeSection(tanOmega, damping, 0, 0, 1);
+        }
+        break;
+      }
+      case Response::Off:
+        break;
+    }
+  }
+
+  static SampleType tick(const Section &c, SectionState &s, SampleType x) noexcept
+  {
+    const auto v3 = x - s.ic2;
+    const auto v1 = c.a1 * s.ic1 + c.a2 * v3;
+    const auto v2 = s.ic2 + c.a2 * s.ic1 + c.a3 * v3;
+    s.ic1 = SampleType(2) * v1 - s.ic1;
+    s.ic2 = SampleType(2) * v2 - s.ic2;
+    return c.m0 * x + c.m1 * v1 + c.m2 * v2;
+  }
+
+  void clearState(size_t stage) noexcept
+  {
+    for (auto &channel : states) {
+      for (size_t i = 0; i < maxSectionsPerStage; i++) {
+        channel[stage * maxSectionsPerStage + i] = {};
+      }
+    }
+  }
+
+  /**
+   * @brief Fixed coefficients, channel by channel so every section stays in registers
+  */
+  void processSteady(const Stage &stage, size_t index, const juce::dsp::AudioBlock<SampleType> &block,
+                     size_t channels, size_t start, size_t count) noexcept
+  {
+    for (size_t ch = 0; ch < channels; ch++) {
+      auto *data = block.getChannelPointer(ch) + start;
+      auto *state = states[ch].data() + index * maxSectionsPerStage;
+
+      for (size_t i = 0; i < count; i++) {
+        auto sample = data[i];
+        for (size_t s = 0; s < stage.numSections; s++) {
+          sample = tick(stage.sections[s], state[s], sample);
+        }
+        data[i] = sample;
+      }
+    }
+  }
+
+  /**
+   * @brief Moving coefficients, sample by sample so every channel uses the sections computed for that sample
+  */
+  void processRamp(Stage &stage, size_t index, const juce::dsp::AudioBlock<SampleType> &block,
+                   size_t channels, size_t count) noexcept
+  {
+    for (size_t i = 0; i < count; i++) {
+      stage.controls.omega *= stage.increments.omega;
+      stage.controls.root *= stage.increments.root;
+      stage.controls.quality += stage.increments.quality;
+      updateSections(stage);
+
+      for (size_t ch = 0; ch < channels; ch++) {
+        auto *state = states[ch].data() + index * maxSectionsPerStage;
+        auto sample = block.getChannelPointer(ch)[i];
+        for (size_t s = 0; s < stage.numSections; s++) {
+          sample = tick(stage.sections[s], state[s], sample);
+        }
+        block.getChannelPointer(ch)[i] = sample;
+      }
+    }
+
+    // land exactly on the targets instead of accumulating the rounding errors of the factors
+    stage.rampRemaining -= count;
+    if (stage.rampRemaining == 0) {
+      stage.controls = stage.targetControls;
+      updateSections(stage);
+    }
+  }
+};
+
+} // namespace audio_plugin
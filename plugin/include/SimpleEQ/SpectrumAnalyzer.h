@@ -0,0 +1,95 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include "SimpleEQ/AnalyzerFifo.h"
+
+#include <memory>
+#include <vector>
+
+namespace audio_plugin {
+
+/**
+ * @brief Turns the audio of an AnalyzerFifo into a smoothed spectrum on a log-frequency grid
+ *
+ * Every update drains the FIFO and runs one Hann windowed FFT frame per hop. The magnitudes are
+ * averaged over time and sampled at the points of the same log-frequency grid the response curve
+ * uses, so both can be drawn on the same axis. Runs entirely on the consumer's thread.
+*/
+class SpectrumAnalyzer {
+public:
+  static constexpr int defaultFftOrder = 11;
+  static constexpr int defaultOverlap = 4;
+
+  /**
+   * @brief Weight of a new frame in the running average, lower values smooth more
+  */
+  static constexpr float averagingWeight = 0.25f;
+
+  /**
+   * @brief Level of the floor of the spectrum, quieter bins are clamped to it
+  */
+  static constexpr float minDecibels = -96.f;
+
+  /**
+   * @brief Smallest move of a grid point that counts as a change, a settled spectrum isn't redrawn
+  */
+  static constexpr float changeThresholdDecibels = 0.1f;
+
+  /**
+   * @brief Attaches to the FIFO, which stays enabled until the analyzer is destroyed
+  */
+  explicit SpectrumAnalyzer(AnalyzerFifo &);
+  ~SpectrumAnalyzer();
+
+  /**
+   * @brief Set the size of the frames and how many of them overlap, e.g. 4 for a hop of a quarter frame
+  */
+  void setFrameSize(int fftOrder, int overlap);
+
+  /**
+   * @brief Set the number of points of the log-frequency grid and the sample rate of the audio
+  */
+  void setGrid(int numPoints, double sampleRate);
+
+  /**
+   * @brief Analyse everything the audio thread pushed since the last call
+   * @return True if a point of the spectrum moved by more than changeThresholdDecibels, e.g. not while it rests on the floor
+  */
+  bool update();
+
+  /**
+   * @brief The averaged spectrum in decibels, one value per grid point
+  */
+  const std::vector<float> &getDecibels() const noexcept { return decibels; }
+
+private:
+  AnalyzerFifo &fifo;
+
+  int fftSize {0}, hopSize {0};
+  std::unique_ptr<juce::dsp::FFT> fft;
+  std::vector<float> window, fftData;
+  float windowNormalisation {1.f};
+
+  // the last fftSize samples, written circularly, and the samples still missing until the next frame
+  std::vector<float> history;
+  int historyPosition {0};
+  int samplesUntilFrame {0};
+  std::vector<float> incoming;
+
+  // averaged power of every bin and the fractional bin of every grid point
+  std::vector<float> binPower;
+  std::vector<float> gridBins;
+  std::vector<float> decibels, nextDecibels;
+  double currentSampleRate {0.0};
+
+  void processFrame();
+  /**
+   * @return True if the new spectrum replaced the previous one
+  */
+  bool updateDecibels();
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyzer)
+};
+
+} // namespace audio_plugin
@@ -0,0 +1,195 @@
+#include "SimpleEQ/ChainSettingsSnapshot.h"
+#include "SimpleEQ/PluginProcessor.h"
+
+#include <bit>
+
+namespace audio_plugin {
+
+/**
+ * @brief Resolve a parameter of the layout by its ID, the type is fixed by createParameterLayout
+*/
+template <typename ParameterType>
+static ParameterType &getTypedParameter(juce::AudioProcessorValueTreeState &apvts, const juce::String &parameterID)
+{
+  auto *parameter = dynamic_cast<ParameterType *>(apvts.getParameter(parameterID));
+  jassert(parameter != nullptr);
+  return *parameter;
+}
+
+ChainSettingsSnapshot::ChainSettingsSnapshot(juce::AudioProcessorValueTreeState &apvts) :
+lowCutFreq(getTypedParameter<juce::AudioParameterFloat>(apvts, "LowCut Freq")),
+highCutFreq(getTypedParameter<juce::AudioParameterFloat>(apvts, "HighCut Freq")),
+peakFreq(getTypedParameter<juce::AudioParameterFloat>(apvts, "Peak Freq")),
+peakGain(getTypedParameter<juce::AudioParameterFloat>(apvts, "Peak Gain")),
+peakQuality(getTypedParameter<juce::AudioParameterFloat>(apvts, "Peak Quality")),
+lowCutSlope(getTypedParameter<juce::AudioParameterChoice>(apvts, "LowCut Slope")),
+highCutSlope(getTypedParameter<juce::AudioParameterChoice>(apvts, "HighCut Slope"))
+{
+  for (size_t i = 0; i < numExtraBands; i++) {
+    auto &band = bandParameters[i];
+    band.type = &getTypedParameter<juce::AudioParameterChoice>(apvts, getBandParameterID(i, "Type"));
+    band.freq = &getTypedParameter<juce::AudioParameterFloat>(apvts, getBandParameterID(i, "Freq"));
+    band.gain = &getTypedParameter<juce::AudioParameterFloat>(apvts, getBandParameterID(i, "Gain"));
+    band.quality = &getTypedParameter<juce::AudioParameterFloat>(apvts, getBandParameterID(i, "Quality"));
+  }
+
+  for (auto *parameter : getParameters()) {
+    parameter->addListener(this);
+  }
+
+  publish();
+}
+
+ChainSettingsSnapshot::~ChainSettingsSnapshot()
+{
+  for (auto *parameter : getParameters()) {
+    parameter->removeListener(this);
+  }
+}
+
+std::array<juce::AudioProcessorParameter *, ChainSettingsSnapshot::numParameters> ChainSettingsSnapshot::getParameters() noexcept
+{
+  std::array<juce::AudioProcessorParameter *, numParameters> parameters {
+    &lowCutFreq, &highCutFreq, &peakFreq, &peakGain, &peakQuality, &lowCutSlope, &highCutSlope
+  };
+
+  for (size_t i = 0; i < numExtraBands; i++) {
+    const auto &band = bandParameters[i];
+    const auto first = 7 + i * wordsPerBand;
+    parameters[first] = band.type;
+    parameters[first + 1] = band.freq;
+    parameters[first + 2] = band.gain;
+    parameters[first + 3] = band.quality;
+  }
+
+  return parameters;
+}
+
+void ChainSettingsSnapshot::parameterValueChanged(int parameterIndex, float newValue)
+{
+  juce::ignoreUnused(parameterIndex, newValue);
+  publish();
+}
+
+ChainSettingsSnapshot::Words ChainSettingsSnapshot::pack() const noexcept
+{
+  // the typed parameters store their value before the listeners are called, unlike the raw values of the apvts
+  Words packed {
+    std::bit_cast<juce::uint32>(lowCutFreq.get()),
+    std::bit_cast<juce::uint32>(highCutFreq.get()),
+    std::bit_cast<juce::uint32>(peakFreq.get()),
+    std::bit_cast<juce::uint32>(peakGain.get()),
+    std::bit_cast<juce::uint32>(peakQuality.get()),
+    static_cast<juce::uint32>(lowCutSlope.getIndex()) | (static_cast<juce::uint32>(highCutSlope.getIndex()) << 8)
+  };
+
+  for (size_t i = 0; i < numExtraBands; i++) {
+    const auto &band = bandParameters[i];
+    const auto first = 6 + i * wordsPerBand;
+    packed[first] = static_cast<juce::uint32>(band.type->getIndex());
+    packed[first + 1] = std::bit_cast<juce::uint32>(band.freq->get());
+    packed[first + 2] = std::bit_cast<juce::uint32>(band.gain->get());
+    packed[first + 3] = std::bit_cast<juce::uint32>(band.quality->get());
+  }
+
+  return packed;
+}
+
+void ChainSettingsSnapshot::publish() noexcept
+{
+  requests.fetch_add(1);
+
+  for (;;) {
+    auto current = sequence.load();
+
+    // somebody else is publishing, they will see the request and publish once more
+    if ((current & 1) != 0 || !sequence.compare_exchange_strong(current, current + 1)) {
+      return;
+    }
+
+    // keeps the stores of the words below from becoming visible before the sequence turned odd
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const auto seen = requests.load();
+    const auto packed = pack();
+
+    for (size_t i = 0; i < numWords; i++) {
+      words[i].store(packed[i], std::memory_order_relaxed);
+    }
+    sequence.store(current + 2);
+
+    if (requests.load() == seen) {
+      return;
+    }
+  }
+}
+
+ChainSettingsSnapshot::Words ChainSettingsSnapshot::load(juce::uint32 &version) const noexcept
+{
+  // a writer only holds the lock for a few stores, but it may be preempted while doing so
+  constexpr int maxAttempts = 4;
+
+  for (int attempt = 0; attempt < maxAttempts; attempt++) {
+    const auto before = sequence.load(std::memory_order_acquire);
+    if ((before & 1) != 0) {
+      continue;
+    }
+
+    Words packed;
+    for (size_t i = 0; i < numWords; i++) {
+      packed[i] = words[i].load(std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence.load(std::memory_order_relaxed) == before) {
+      version = before;
+      return packed;
+    }
+  }
+
+  // rather than spin on a stalled writer, read the parameters directly and read again next time
+  version = noVersion;
+  return pack();
+}
+
+ChainSettings ChainSettingsSnapshot::unpack(const Words &packed) noexcept
+{
+  ChainSettings settings;
+
+  settings.lowCutFreq = std::bit_cast<float>(packed[0]);
+  settings.highCutFreq = std::bit_cast<float>(packed[1]);
+  settings.peakFreq = std::bit_cast<float>(packed[2]);
+  settings.peakGainInDecibels = std::bit_cast<float>(packed[3]);
+  settings.peakQuality = std::bit_cast<float>(packed[4]);
+  settings.lowCutSlope = static_cast<Slope>(packed[5] & 0xff);
+  settings.highCutSlope = static_cast<Slope>((packed[5] >> 8) & 0xff);
+
+  for (size_t i = 0; i < numExtraBands; i++) {
+    auto &band = settings.bands[i];
+    const auto first = 6 + i * wordsPerBand;
+    band.type = static_cast<BandType>(packed[first]);
+    band.freq = std::bit_cast<float>(packed[first + 1]);
+    band.gainInDecibels = std::bit_cast<float>(packed[first + 2]);
+    band.quality = std::bit_cast<float>(packed[first + 3]);
+  }
+
+  return settings;
+}
+
+ChainSettings ChainSettingsSnapshot::read() const noexcept
+{
+  juce::uint32 version;
+  return unpack(load(version));
+}
+
+bool ChainSettingsSnapshot::readIfChanged(juce::uint32 &lastVersion, ChainSettings &settings) const noexcept
+{
+  if (getVersion() == lastVersion) {
+    return false;
+  }
+
+  settings = unpack(load(lastVersion));
+  return true;
+}
+
+} // namespace audio_plugin
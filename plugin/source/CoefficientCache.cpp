@@ -0,0 +1,128 @@
+#include "SimpleEQ/CoefficientCache.h"
+
+#include <bit>
+
+namespace audio_plugin {
+
+CoefficientCache::KeyWords CoefficientCache::pack(const Key &key) noexcept
+{
+  return {(static_cast<juce::uint64>(key.kind) << 32) | key.order,
+          (static_cast<juce::uint64>(std::bit_cast<juce::uint32>(key.freq)) << 32) | std::bit_cast<juce::uint32>(key.quality),
+          std::bit_cast<juce::uint32>(key.gainInDecibels),
+          std::bit_cast<juce::uint64>(key.sampleRate)};
+}
+
+size_t CoefficientCache::getBucket(const KeyWords &words) noexcept
+{
+  // mix every bit of the key into the index, nearby frequencies must not pile up in one bucket
+  juce::uint64 hash = 0x9e3779b97f4a7c15ull;
+  for (auto word : words) {
+    hash ^= word + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    hash ^= hash >> 31;
+    hash *= 0xbf58476d1ce4e5b9ull;
+  }
+  return static_cast<size_t>(hash ^ (hash >> 29)) % numBuckets;
+}
+
+bool CoefficientCache::lookup(const Key &key, Sections &sections) noexcept
+{
+  jassert(key.kind != 0);
+  const auto words = pack(key);
+  const auto first = getBucket(words) * numWays;
+
+  for (size_t way = 0; way < numWays; way++) {
+    auto &slot = slots[first + way];
+
+    const auto before = slot.sequence.load(std::memory_order_acquire);
+    if ((before & 1) != 0) {
+      continue;
+    }
+
+    auto matches = true;
+    for (size_t i = 0; i < keyWords && matches; i++) {
+      matches = slot.key[i].load(std::memory_order_relaxed) == words[i];
+    }
+    if (!matches) {
+      continue;
+    }
+
+    for (size_t i = 0; i < sectionWords; i++) {
+      sections[i / 6][i % 6] = std::bit_cast<double>(slot.sections[i].load(std::memory_order_relaxed));
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) == before) {
+      slot.lastUsed.store(clock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+      hits.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+
+  misses.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void CoefficientCache::insert(const Key &key, const Sections &sections) noexcept
+{
+  jassert(key.kind != 0);
+  const auto words = pack(key);
+  const auto first = getBucket(words) * numWays;
+  const auto now = clock.fetch_add(1, std::memory_order_relaxed);
+
+  // an empty slot if there is one, otherwise the one that was used longest ago, the clock may wrap around
+  auto *victim = &slots[first];
+  for (size_t way = 0; way < numWays; way++) {
+    auto &slot = slots[first + way];
+    if (slot.key[0].load(std::memory_order_relaxed) == 0) {
+      victim = &slot;
+      break;
+    }
+    if (now - slot.lastUsed.load(std::memory_order_relaxed) > now - victim->lastUsed.load(std::memory_order_relaxed)) {
+      victim = &slot;
+    }
+  }
+
+  auto sequence = victim->sequence.load(std::memory_order_relaxed);
+  if ((sequence & 1) != 0 || !victim->sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_relaxed)) {
+    return;
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+
+  if (victim->key[0].load(std::memory_order_relaxed) != 0) {
+    evictions.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  for (size_t i = 0; i < keyWords; i++) {
+    victim->key[i].store(words[i], std::memory_order_relaxed);
+  }
+  for (size_t i = 0; i < sectionWords; i++) {
+    victim->sections[i].store(std::bit_cast<juce::uint64>(sections[i / 6][i % 6]), std::memory_order_relaxed);
+  }
+  victim->lastUsed.store(now, std::memory_order_relaxed);
+  victim->sequence.store(sequence + 2, std::memory_order_release);
+
+  insertions.fetch_add(1, std::memory_order_relaxed);
+}
+
+CoefficientCache::Statistics CoefficientCache::getStatistics() const noexcept
+{
+  return {hits.load(std::memory_order_relaxed), misses.load(std::memory_order_relaxed),
+          insertions.load(std::memory_order_relaxed), evictions.load(std::memory_order_relaxed)};
+}
+
+void CoefficientCache::clear() noexcept
+{
+  for (auto &slot : slots) {
+    for (auto &word : slot.key) {
+      word.store(0, std::memory_order_relaxed);
+    }
+    slot.lastUsed.store(0, std::memory_order_relaxed);
+  }
+
+  hits.store(0);
+  misses.store(0);
+  insertions.store(0);
+  evictions.store(0);
+}
+
+} // namespace audio_plugin
@@ -0,0 +1,150 @@
+#include "SimpleEQ/LinearPhaseFilter.h"
+#include "SimpleEQ/PluginProcessor.h"
+#include "SimpleEQ/ResponseCurve.h"
+
+namespace audio_plugin {
+
+LinearPhaseFilter::LinearPhaseFilter(const ChainSettingsSnapshot &chainSettingsSnapshot) :
+snapshot(chainSettingsSnapshot),
+response(std::make_unique<ResponseCurve>())
+{
+}
+
+LinearPhaseFilter::~LinearPhaseFilter()
+{
+  // waits for a design that is still running
+  designThread->removeTimeSliceClient(this);
+}
+
+void LinearPhaseFilter::prepare(const juce::dsp::ProcessSpec &spec, double newDesignSampleRate)
+{
+  designThread->removeTimeSliceClient(this);
+
+  sampleRate = spec.sampleRate;
+  kernelLength = juce::nextPowerOfTwo(juce::roundToInt(sampleRate * kernelLengthInSeconds));
+
+  fft = std::make_unique<juce::dsp::FFT>(juce::findHighestSetBit(static_cast<juce::uint32>(kernelLength)));
+  fftBuffer.assign(static_cast<size_t>(2 * kernelLength), 0.f);
+
+  // one sample longer than the kernel, so the window is symmetric around the centre tap
+  window.assign(static_cast<size_t>(kernelLength + 1), 0.f);
+  juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), window.size(), 
+                                                           juce::dsp::WindowingFunction<float>::blackman, false);
+
+  binFrequencies.resize(static_cast<size_t>(kernelLength / 2 + 1));
+  for (size_t bin = 0; bin < binFrequencies.size(); bin++) {
+    binFrequencies[bin] = static_cast<double>(bin) * sampleRate / kernelLength;
+  }
+
+  designSampleRate.store(newDesignSampleRate);
+  designedSampleRate = 0.0;
+  designedVersion = ChainSettingsSnapshot::noVersion;
+
+  convolutions.clear();
+  for (juce::uint32 channel = 0; channel < spec.numChannels; channel += 2) {
+    convolutions.push_back(std::make_unique<juce::dsp::Convolution>(juce::dsp::Convolution::NonUniform {headSize}, *messageQueue));
+  }
+
+  // the first kernel is designed here and loaded before the convolutions are prepared: prepare runs the
+  // pending loads of the message queue and builds its engine from them, so the first block, e.g. of an
+  // offline render, is already filtered and delayed by the reported latency
+  updateKernel();
+
+  for (size_t pair = 0; pair < convolutions.size(); pair++) {
+    const auto numChannels = juce::jmin(2u, spec.numChannels - static_cast<juce::uint32>(2 * pair));
+    convolutions[pair]->prepare({spec.sampleRate, spec.maximumBlockSize, numChannels});
+  }
+
+  designThread->addTimeSliceClient(this);
+}
+
+void LinearPhaseFilter::reset() noexcept
+{
+  for (auto &convolution : convolutions) {
+    convolution->reset();
+  }
+}
+
+void LinearPhaseFilter::process(const juce::dsp::ProcessContextReplacing<float> &context) noexcept
+{
+  if (context.isBypassed) {
+    return;
+  }
+
+  auto &block = context.getOutputBlock();
+  const auto numChannels = block.getNumChannels();
+
+  for (size_t pair = 0; pair < convolutions.size() && 2 * pair < numChannels; pair++) {
+    auto channels = block.getSubsetChannelBlock(2 * pair, juce::jmin<size_t>(2, numChannels - 2 * pair));
+    convolutions[pair]->process(juce::dsp::ProcessContextReplacing<float>(channels));
+  }
+}
+
+int LinearPhaseFilter::useTimeSlice()
+{
+  if (active.load()) {
+    updateKernel();
+  }
+  return pollIntervalMs;
+}
+
+void LinearPhaseFilter::updateKernel()
+{
+  ChainSettings settings;
+  const auto settingsChanged = snapshot.readIfChanged(designedVersion, settings);
+  const auto rate = designSampleRate.load();
+
+  if (!settingsChanged && rate == designedSampleRate) {
+    return;
+  }
+  if (!settingsChanged) {
+    settings = snapshot.read();
+  }
+
+  // the bins cover the audio rate, the stages are designed like the IIR chain, e.g. at the oversampled rate
+  if (rate != designedSampleRate) {
+    response->prepare(binFrequencies, rate);
+    designedSampleRate = rate;
+  }
+
+  auto peakCoefficients = designPeakFilter(settings, rate);
+  auto lowCutCoefficients = designLowCutFilter(settings, rate);
+  auto highCutCoefficients = designHighCutFilter(settings, rate);
+
+  response->setStage(ChainPositions::Peak, &peakCoefficients, 1);
+  response->setStage(ChainPositions::LowCut, lowCutCoefficients.data(), getNumSections(settings.lowCutSlope));
+  response->setStage(ChainPositions::HighCut, highCutCoefficients.data(), getNumSections(settings.highCutSlope));
+
+  for (size_t i = 0; i < numExtraBands; i++) {
+    auto bandCoefficients = designBand(settings.bands[i], rate);
+    response->setStage(getBandPosition(i), &bandCoefficients, getNumSections(settings.bands[i]));
+  }
+
+  // zero phase spectrum, the inverse transform gives a kernel that is symmetric around sample 0
+  const auto &power = response->getPower();
+  std::fill(fftBuffer.begin(), fftBuffer.end(), 0.f);
+  for (size_t bin = 0; bin < power.size(); bin++) {
+    fftBuffer[2 * bin] = static_cast<float>(std::sqrt(power[bin]));
+  }
+
+  fft->performRealOnlyInverseTransform(fftBuffer.data());
+
+  // centre the kernel, which makes it causal with a delay of half its length
+  juce::AudioBuffer<float> kernel(1, kernelLength);
+  auto *taps = kernel.getWritePointer(0);
+  const auto half = kernelLength / 2;
+
+  for (int i = 0; i < kernelLength; i++) {
+    taps[i] = fftBuffer[static_cast<size_t>((i + half) % kernelLength)] * window[static_cast<size_t>(i)];
+  }
+
+  for (auto &convolution : convolutions) {
+    convolution->loadImpulseResponse(juce::AudioBuffer<float>(kernel), 
+                                     sampleRate, 
+                                     juce::dsp::Convolution::Stereo::no, 
+                                     juce::dsp::Convolution::Trim::no, 
+                                     juce::dsp::Convolution::Normalise::no);
+  }
+}
+
+} // namespace audio_plugin
@@ -3,19 +3,28 @@
 
 namespace audio_plugin {
 
-ResponseCurveComponent::ResponseCurveComponent(SimpleEQAudioProcessor &p) : processorRef(p) 
+ResponseCurveComponent::ResponseCurveComponent(SimpleEQAudioProcessor &p) : 
+processorRef(p), 
+renderer(p), 
+inputAnalyzer(p.getInputAnalyzerFifo()), 
+outputAnalyzer(p.getOutputAnalyzerFifo())
 {
+  setOpaque(true);
+  renderer.start();
+
   const auto& params = processorRef.getParameters();
   for(auto param : params) {
     param->addListener(this);
   }
 
-  startTimerHz(60);
   parametersChanged.set(true);
+  wakeUp();
 }
 
 ResponseCurveComponent::~ResponseCurveComponent() 
 {
+  processorRef.getEditorWakeUp().setArmed(false);
+
   const auto& params = processorRef.getParameters();
   for(auto param : params) {
     param->removeListener(this);
@@ -29,127 +38,236 @@ void ResponseCurveComponent::parameterValueChanged(int parameterIndex, float new
   juce::ignoreUnused(newValue);
   
   parametersChanged.set(true);
+
+  // host automation arrives on the audio thread, which must not post messages, the watch timer picks it up
+  if (juce::MessageManager::existsAndIsCurrentThread()) {
+    wakeUp();
+  }
 }
 
 void ResponseCurveComponent::parameterGestureChanged(int parameterIndex, bool gestureIsStarting) 
 {
-  // ignore unused parameterIndex
-  juce::ignoreUnused(parameterIndex);
+  // the end of a gesture carries no new value, the last parameterValueChanged already marked it
+  juce::ignoreUnused(parameterIndex, gestureIsStarting);
+}
 
-  if(!gestureIsStarting) {
-    parametersChanged.set(false);
+void ResponseCurveComponent::wakeUp()
+{
+  idleFrames = 0;
+  if (vBlankAttachment == nullptr) {
+    stopTimer();
+    processorRef.getEditorWakeUp().setArmed(false);
+    vBlankAttachment = std::make_unique<juce::VBlankAttachment>(this, [this] { onVBlank(); });
   }
 }
 
-void ResponseCurveComponent::timerCallback() 
+void ResponseCurveComponent::onVBlank()
 {
+  auto busy = false;
+
   if(parametersChanged.compareAndSetBool(false, true)) {
-    // update the UI
-    auto chainSettings = getChainSettings(processorRef.apvts);
-    auto sampleRate = processorRef.getSampleRate();
+    // the renderer picks up the new parameters on its own thread
+    renderer.requestUpdate();
+    busy = true;
+  }
 
-    auto peakCoefficients = makePeakFilter(chainSettings, sampleRate);
+  const auto spectraChanged = updateSpectra();
+  const auto frameReady = renderer.isFrameReady();
 
-    updateCoefficients(monoChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
+  if(frameReady || spectraChanged) {
+    repaint();
+  }
+
+  busy = busy || spectraChanged || frameReady || renderer.isUpdatePending();
+  idleFrames = busy ? 0 : idleFrames + 1;
+
+  if (idleFrames == idleFramesBeforeSleeping) {
+    // the attachment can't be destroyed from inside its own callback
+    juce::MessageManager::callAsync([safeThis = juce::Component::SafePointer<ResponseCurveComponent>(this)] {
+      if (safeThis != nullptr && safeThis->idleFrames >= idleFramesBeforeSleeping) {
+        safeThis->goToSleep();
+      }
+    });
+  }
+}
 
-    auto lowCutCoefficients = makeLowCutFilter(chainSettings, sampleRate);
-    auto highCutCoefficients = makeHighCutFilter(chainSettings, sampleRate);
+void ResponseCurveComponent::goToSleep()
+{
+  vBlankAttachment.reset();
+  processorRef.getEditorWakeUp().setArmed(true);
+  startTimer(watchIntervalMilliseconds);
+}
 
-    updateCutFilters(monoChain.get<ChainPositions::LowCut>(), lowCutCoefficients, chainSettings.lowCutSlope);
-    updateCutFilters(monoChain.get<ChainPositions::HighCut>(), highCutCoefficients, chainSettings.highCutSlope);
+void ResponseCurveComponent::timerCallback()
+{
+  if (parametersChanged.get()) {
+    wakeUp();
+    return;
+  }
 
+  // audio is analysed here while the component sleeps, it only wakes up if the spectra moved
+  if (processorRef.getEditorWakeUp().consumeRequest() && updateSpectra()) {
     repaint();
+    wakeUp();
   }
+}
 
+void ResponseCurveComponent::resized()
+{
+  renderBackground();
+  renderer.setSize(getWidth(), getHeight());
+
+  // the grid of the spectra follows the width, like the points of the response curve
+  analyzerSampleRate = 0.0;
+  wakeUp();
 }
 
-void ResponseCurveComponent::paint(juce::Graphics &g) {
+bool ResponseCurveComponent::updateSpectra()
+{
+  const auto sampleRate = processorRef.getSampleRate();
+  if (sampleRate <= 0.0 || getWidth() <= 0) {
+    return false;
+  }
+
+  if (sampleRate != analyzerSampleRate) {
+    analyzerSampleRate = sampleRate;
+    inputAnalyzer.setGrid(getWidth(), sampleRate);
+    outputAnalyzer.setGrid(getWidth(), sampleRate);
+  }
+
+  const auto inputChanged = inputAnalyzer.update();
+  const auto outputChanged = outputAnalyzer.update();
+  if (!inputChanged && !outputChanged) {
+    return false;
+  }
+
+  const auto height = static_cast<float>(getHeight());
+  auto map = [height](float decibels) {
+    return juce::jmap(decibels, spectrumMinDecibels, spectrumMaxDecibels, height, 0.f);
+  };
+
+  auto buildPath = [&map, height](juce::Path &path, const std::vector<float> &decibels) {
+    path.clear();
+    path.preallocateSpace(3 * static_cast<int>(decibels.size()) + 6);
+    path.startNewSubPath(0.f, height);
+
+    for (size_t i = 0; i < decibels.size(); i++) {
+      path.lineTo(static_cast<float>(i), map(decibels[i]));
+    }
+
+    path.lineTo(static_cast<float>(decibels.size()), height);
+    path.closeSubPath();
+  };
+
+  buildPath(inputSpectrumPath, inputAnalyzer.getDecibels());
+  buildPath(outputSpectrumPath, outputAnalyzer.getDecibels());
+
+  return true;
+}
+
+void ResponseCurveComponent::renderBackground()
+{
+  using namespace juce;
+
+  auto responseArea = getLocalBounds();
+  if (responseArea.isEmpty()) {
+    background = {};
+    return;
+  }
+
+  background = Image(Image::RGB, responseArea.getWidth(), responseArea.getHeight(), true);
+  Graphics g(background);
+
   // (Our component is opaque, so we must completely fill the background with a
   // solid colour)
-  using namespace juce;
   g.fillAll(Colours::black);
 
-  auto responseArea = getLocalBounds();
+  const auto width = static_cast<float>(responseArea.getWidth());
+  const auto height = static_cast<float>(responseArea.getHeight());
 
-  auto w = responseArea.getWidth();
+  g.setColour(Colours::darkgrey);
+  for (auto freq : {50.f, 100.f, 200.f, 500.f, 1000.f, 2000.f, 5000.f, 10000.f}) {
+    auto normX = mapFromLog10(freq, static_cast<float>(ResponseCurve::minFrequency), static_cast<float>(ResponseCurve::maxFrequency));
+    g.drawVerticalLine(roundToInt(normX * width), 0.f, height);
+  }
 
-  auto& lowCut = monoChain.get<ChainPositions::LowCut>();
-  auto& peak = monoChain.get<ChainPositions::Peak>();
-  auto& highCut = monoChain.get<ChainPositions::HighCut>();
+  for (auto gainDb : {-12.f, 0.f, 12.f}) {
+    auto y = jmap(gainDb, -24.f, 24.f, height, 0.f);
+    g.drawHorizontalLine(roundToInt(y), 0.f, width);
+  }
 
-  auto sampleRate = processorRef.getSampleRate();
+  g.setColour(Colours::grey);
+  g.drawRoundedRectangle(responseArea.toFloat(), 4.f, 1.f);
+}
 
-  std::vector<double> mags;
+void ResponseCurveComponent::paint(juce::Graphics &g) {
+  g.drawImageAt(background, 0, 0);
 
-  mags.resize(static_cast<size_t>(w));
+  g.setColour(juce::Colours::grey.withAlpha(0.35f));
+  g.fillPath(inputSpectrumPath);
+  g.setColour(juce::Colours::skyblue.withAlpha(0.6f));
+  g.strokePath(outputSpectrumPath, juce::PathStrokeType(1.f));
 
-  // compute maknitude of the Eq Curve for every pixel of the width
-  for(int i = 0; i < w; i++) {
-    // 1.0 is the default magnitude
-    double mag = 1.f;
-    auto freq = mapToLog10<double>(double(i) / double(w), 20, 20000);
+  // the frame can lag behind a resize by one render, it is drawn unscaled until the next one arrives
+  g.drawImageAt(renderer.acquireFrame(), 0, 0);
+}
 
-    // compute the magnitude of the filter chain
-    // peak filter
-    if(!monoChain.isBypassed<ChainPositions::Peak>()) {
-      mag *= peak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
-    }
-    // low cut filter
-    if(!lowCut.isBypassed<0>()) {
-      mag *= lowCut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-    }
-    if(!lowCut.isBypassed<1>()) {
-      mag *= lowCut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-    }
-    if(!lowCut.isBypassed<2>()) {
-      mag *= lowCut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-    }
-    if(!lowCut.isBypassed<3>()) {
-      mag *= lowCut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-    }
-    // high cut filter
-    if(!highCut.isBypassed<0>()) {
-      mag *= highCut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-    }
-    if(!highCut.isBypassed<1>()) {
-      mag *= highCut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-    }
-    if(!highCut.isBypassed<2>()) {
-      mag *= highCut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-    }
-    if(!highCut.isBypassed<3>()) {
-      mag *= highCut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-    }
+ProfilerOverlay::ProfilerOverlay(const Profiler &p) : profiler(p)
+{
+  setInterceptsMouseClicks(false, false);
 
-    mags[static_cast<size_t>(i)] = Decibels::gainToDecibels(mag);
+  for (size_t section = 0; section < Profiler::numSections; section++) {
+    previous[section] = profiler.getHistogram(static_cast<Profiler::Section>(section)).getSnapshot();
   }
 
-  Path responseCurve;
+  if constexpr (Profiler::isEnabled) {
+    startTimer(intervalMilliseconds);
+  }
+}
+
+void ProfilerOverlay::timerCallback()
+{
+  for (size_t section = 0; section < Profiler::numSections; section++) {
+    const auto snapshot = profiler.getHistogram(static_cast<Profiler::Section>(section)).getSnapshot();
+    const auto counts = DurationHistogram::getDifference(snapshot, previous[section]);
+    previous[section] = snapshot;
 
-  const double outputMin = responseArea.getBottom();
-  const double outputMax = responseArea.getY();
+    percentiles[section] = {DurationHistogram::getPercentile(counts, 0.5) / 1000.0, 
+                            DurationHistogram::getPercentile(counts, 0.99) / 1000.0};
+  }
+  repaint();
+}
 
-  // Map decibels to Screen coordinates
-  auto map = [outputMin, outputMax](double input) {
-    return jmap(input, -24.0, 24.0, outputMin, outputMax);
+void ProfilerOverlay::paint(juce::Graphics &g)
+{
+  g.setColour(juce::Colours::black.withAlpha(0.6f));
+  g.fillRoundedRectangle(getLocalBounds().toFloat(), 3.f);
+  g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 10.f, juce::Font::plain));
+
+  auto row = getLocalBounds().reduced(4, 2).removeFromTop(rowHeight);
+  auto drawRow = [&g, &row](const juce::String &name, const juce::String &p50, const juce::String &p99) {
+    auto cells = row;
+    g.drawText(name, cells.removeFromLeft(cells.getWidth() / 2), juce::Justification::centredLeft);
+    g.drawText(p50, cells.removeFromLeft(cells.getWidth() / 2), juce::Justification::centredRight);
+    g.drawText(p99, cells, juce::Justification::centredRight);
+    row.translate(0, rowHeight);
   };
-  
-  responseCurve.startNewSubPath(responseArea.getX(), map(mags.front()));
 
-  for(int i = 1; i < static_cast<int>(mags.size()); i++) {
-    responseCurve.lineTo(responseArea.getX() + i, map(mags[static_cast<size_t>(i)]));
-  }
+  auto format = [](double microseconds) { return microseconds > 0.0 ? juce::String(microseconds, 1) : juce::String("-"); };
 
-  g.setColour(Colours::grey);
-  g.drawRoundedRectangle(responseArea.toFloat(), 4.f, 1.f);
+  g.setColour(juce::Colours::grey);
+  drawRow(juce::String::fromUTF8("\xc2\xb5s per block"), "p50", "p99");
 
-  g.setColour(Colours::white);
-  g.strokePath(responseCurve, PathStrokeType(2.f));
+  g.setColour(juce::Colours::lightgrey);
+  for (size_t section = 0; section < Profiler::numSections; section++) {
+    drawRow(Profiler::sectionNames[section], format(percentiles[section][0]), format(percentiles[section][1]));
+  }
 }
 
 SimpleEQEditor::SimpleEQEditor(SimpleEQAudioProcessor &p) : AudioProcessorEditor(&p), 
   processorRef(p), 
   responseCurveComponent(p),
+  profilerOverlay(p.getProfiler()),
   peakFreqSlider(*processorRef.apvts.getParameter("Peak Freq"), "Hz"),
   peakGainSlider(*processorRef.apvts.getParameter("Peak Gain"), "dB"),
   peakQualitySlider(*processorRef.apvts.getParameter("Peak Quality"), ""),
@@ -172,6 +290,11 @@ SimpleEQEditor::SimpleEQEditor(SimpleEQAudioProcessor &p) : AudioProcessorEditor
   for (auto *comp : getComps()) {
     addAndMakeVisible(comp);
   }
+
+  // without SIMPLEEQ_PROFILING there is nothing to show
+  if constexpr (Profiler::isEnabled) {
+    addAndMakeVisible(profilerOverlay);
+  }
   setSize(800, 600);
 }
 
@@ -184,6 +307,7 @@ void SimpleEQEditor::resized() {
   auto responseArea = bounds.removeFromTop(bounds.getHeight() * 0.33);
 
   responseCurveComponent.setBounds(responseArea);
+  profilerOverlay.setBounds(responseArea.reduced(6).removeFromTop(ProfilerOverlay::height).removeFromRight(ProfilerOverlay::width));
 
   auto lowCutArea = bounds.removeFromLeft(bounds.getWidth() * 0.33);
   auto highCutArea = bounds.removeFromRight(bounds.getWidth() * 0.5);
@@ -1,5 +1,8 @@
 #include "SimpleEQ/PluginProcessor.h"
 #include "SimpleEQ/PluginEditor.h"
+#include "SimpleEQ/FilterDesigner.h"
+
+#include <algorithm>
 
 namespace audio_plugin {
 
@@ -12,9 +15,27 @@ SimpleEQAudioProcessor::SimpleEQAudioProcessor() : AudioProcessor
 #endif
               .withOutput("Output", juce::AudioChannelSet::stereo(), true)
 #endif
-) {}
+),
+smoothingParameter(*dynamic_cast<juce::AudioParameterBool *>(apvts.getParameter("Smoothing"))),
+oversamplingParameter(*dynamic_cast<juce::AudioParameterChoice *>(apvts.getParameter("Oversampling"))),
+linearPhaseParameter(*dynamic_cast<juce::AudioParameterBool *>(apvts.getParameter("Linear Phase")))
+{
+  oversamplingParameter.addListener(this);
+  linearPhaseParameter.addListener(this);
 
-SimpleEQAudioProcessor::~SimpleEQAudioProcessor() {}
+  if constexpr (Profiler::isEnabled) {
+    const auto tracePath = juce::SystemStats::getEnvironmentVariable(ProfileTraceWriter::environmentVariable, {});
+    if (wrapperType == wrapperType_Standalone && tracePath.isNotEmpty()) {
+      traceWriter = std::make_unique<ProfileTraceWriter>(profiler, juce::File::getCurrentWorkingDirectory().getChildFile(tracePath));
+    }
+  }
+}
+
+SimpleEQAudioProcessor::~SimpleEQAudioProcessor() 
+{
+  oversamplingParameter.removeListener(this);
+  linearPhaseParameter.removeListener(this);
+}
 
 const juce::String SimpleEQAudioProcessor::getName() const 
 {
@@ -48,26 +69,63 @@ bool SimpleEQAudioProcessor::isMidiEffect() const
 #endif
 }
 
-double SimpleEQAudioProcessor::getTailLengthSeconds() const { return 0.0; }
+double SimpleEQAudioProcessor::getTailLengthSeconds() const 
+{
+  return getTailLengthSeconds(chainSettingsSnapshot.read());
+}
+
+double SimpleEQAudioProcessor::getTailLengthSeconds(const ChainSettings &chainSettings) const noexcept
+{
+  const auto sampleRate = getSampleRate() > 0.0 ? getSampleRate() : 44100.0;
+
+  // the windowed kernel already contains the decay of the chain, the output ends one kernel after the input
+  if (linearPhaseParameter.get()) {
+    return 2.0 * linearPhaseLatency / sampleRate;
+  }
+
+  const auto oversampling = static_cast<size_t>(oversamplingParameter.getIndex());
+  return calculateTailLengthSeconds(chainSettings, sampleRate * (1 << oversampling)) 
+         + oversamplingLatencies[oversampling] / sampleRate;
+}
+
+void SimpleEQAudioProcessor::updateTailLength() noexcept
+{
+  const auto mode = linearPhaseParameter.get() ? -1 : oversamplingParameter.getIndex();
+  if (mode != tailMode) {
+    tailMode = mode;
+    tailVersion = ChainSettingsSnapshot::noVersion;
+  }
+
+  ChainSettings chainSettings;
+  if (chainSettingsSnapshot.readIfChanged(tailVersion, chainSettings)) {
+    tailLengthInSamples = static_cast<juce::int64>(std::ceil(getTailLengthSeconds(chainSettings) * getSampleRate()));
+  }
+}
 
 int SimpleEQAudioProcessor::getNumPrograms() 
 {
-  return 1; // NB: some hosts don't cope very well if you tell them there are 0
-            // programs, so this should be at least 1, even if you're not really
-            // implementing programs.
+  return presetBank.getNumPrograms();
 }
 
-int SimpleEQAudioProcessor::getCurrentProgram() { return 0; }
+int SimpleEQAudioProcessor::getCurrentProgram() { return requestedProgram.load(); }
 
 void SimpleEQAudioProcessor::setCurrentProgram(int index) 
 {
-  juce::ignoreUnused(index);
+  if (!juce::isPositiveAndBelow(index, presetBank.getNumPrograms())) {
+    return;
+  }
+
+  // the parameters go first, so the audio thread finds them matching the program once it switches
+  setChainSettings(chainParameters, presetBank.getSettings(index));
+  requestedProgram.store(index);
 }
 
 const juce::String SimpleEQAudioProcessor::getProgramName(int index) 
 {
-  juce::ignoreUnused(index);
-  return {};
+  if (!juce::isPositiveAndBelow(index, presetBank.getNumPrograms())) {
+    return {};
+  }
+  return presetBank.getName(index);
 }
 
 void SimpleEQAudioProcessor::changeProgramName(int index, const juce::String &newName) 
@@ -78,17 +136,75 @@ void SimpleEQAudioProcessor::changeProgramName(int index, const juce::String &ne
 void SimpleEQAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) 
 {
   // Use this method as the place to do any pre-playback initialisation that you need..
+  const auto numChannels = juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels());
+
+  // prepare every factor up front, so the choice can be switched while playing
+  for (size_t factor = 1; factor < oversamplers.size(); factor++) {
+    oversamplers[factor] = std::make_unique<juce::dsp::Oversampling<float>>(static_cast<size_t>(numChannels), 
+                                                                            factor,
+                                                                            juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR,
+                                                                            true,
+                                                                            true);
+    oversamplers[factor]->initProcessing(static_cast<size_t>(samplesPerBlock));
+    oversamplingLatencies[factor] = juce::roundToInt(oversamplers[factor]->getLatencyInSamples());
+
+    // same design in double precision, so both have the same latency
+    doubleOversamplers[factor] = std::make_unique<juce::dsp::Oversampling<double>>(static_cast<size_t>(numChannels), 
+                                                                                   factor,
+                                                                                   juce::dsp::Oversampling<double>::filterHalfBandPolyphaseIIR,
+                                                                                   true,
+                                                                                   true);
+    doubleOversamplers[factor]->initProcessing(static_cast<size_t>(samplesPerBlock));
+  }
+
   juce::dsp::ProcessSpec spec;
 
-  spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
-  spec.numChannels = 1;
+  spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock) << (oversamplers.size() - 1);
+  spec.numChannels = static_cast<juce::uint32>(numChannels);
   spec.sampleRate = sampleRate;
 
-  // Prepare the chains
-  leftChain.prepare(spec);
-  rightChain.prepare(spec);
+  // Prepare the chain
+  chain.prepare(spec);
+  doubleChain.prepare(spec);
+  stateVariableChain.prepare(spec);
+  doubleStateVariableChain.prepare(spec);
+  activeFilterEngine = filterEngine.load();
+
+  doubleScratch.setSize(numChannels, static_cast<int>(spec.maximumBlockSize));
+  floatScratch.setSize(numChannels, samplesPerBlock);
+
+  // every program is designed for every factor up front, switching never designs on the audio thread
+  presetBank.prepare(sampleRate);
+  fadeChain.prepare(spec);
+  doubleFadeChain.prepare(spec);
+  fadeScratch.setSize(numChannels, static_cast<int>(spec.maximumBlockSize));
+  doubleFadeScratch.setSize(numChannels, static_cast<int>(spec.maximumBlockSize));
+  activeProgram = requestedProgram.load();
+
+  // the wrapper sets the precision before preparing, the audio thread still checks in case a host doesn't
+  doubleProcessing = isUsingDoublePrecision();
+  activePrecisionMode = precisionMode.load();
+
+  activeOversampling = oversamplingParameter.getIndex();
+  processingSampleRate = sampleRate * (1 << activeOversampling);
+
+  // the FIR runs at the host's rate, its magnitude follows the IIR designs at the oversampled rate
+  linearPhaseFilter.prepare({sampleRate, static_cast<juce::uint32>(samplesPerBlock), static_cast<juce::uint32>(numChannels)}, 
+                            processingSampleRate);
+  linearPhaseLatency = linearPhaseFilter.getLatencyInSamples();
+  linearPhaseActive = linearPhaseParameter.get();
+  linearPhaseFilter.setActive(linearPhaseActive);
 
-  // update Filters
+  updateLatency();
+
+  // the tail depends on the sample rate
+  tailVersion = ChainSettingsSnapshot::noVersion;
+  silentSamples = 0;
+  idle = false;
+
+  // the sample rate may have changed, so every stage has to be redesigned
+  smoothingActive = isSmoothingEnabled();
+  resetFilterDesign();
   updateFilters();
 }
 
@@ -105,11 +221,9 @@ bool SimpleEQAudioProcessor::isBusesLayoutSupported(const BusesLayout &layouts)
   return true;
 #else
   // This is the place where you check if the layout is supported.
-  // In this template code we only support mono or stereo.
-  // Some plugin hosts, such as certain GarageBand versions, will only
-  // load plugins that support stereo bus layouts.
-  if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono() &&
-      layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+  // The chain handles any number of channels, from mono up to immersive and ambisonic layouts,
+  // so the only requirement is an enabled main bus.
+  if (layouts.getMainOutputChannelSet().isDisabled())
     return false;
 
     // This checks if the input layout matches the output layout
@@ -125,7 +239,27 @@ bool SimpleEQAudioProcessor::isBusesLayoutSupported(const BusesLayout &layouts)
 void SimpleEQAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midiMessages) 
 {
   juce::ignoreUnused(midiMessages);
+  profiler.beginBlock(buffer.getNumSamples());
+  processBlockInPrecision(buffer);
+  profiler.endBlock();
+}
+
+void SimpleEQAudioProcessor::processBlock(juce::AudioBuffer<double> &buffer, juce::MidiBuffer &midiMessages) 
+{
+  juce::ignoreUnused(midiMessages);
+  profiler.beginBlock(buffer.getNumSamples());
+  processBlockInPrecision(buffer);
+  profiler.endBlock();
+}
+
+bool SimpleEQAudioProcessor::supportsDoublePrecisionProcessing() const 
+{
+  return true;
+}
 
+template <typename SampleType>
+void SimpleEQAudioProcessor::processBlockInPrecision(juce::AudioBuffer<SampleType> &buffer) 
+{
   juce::ScopedNoDenormals noDenormals;
   auto totalNumInputChannels = getTotalNumInputChannels();
   auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -139,20 +273,425 @@ void SimpleEQAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer, juce
   for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
     buffer.clear(i, 0, buffer.getNumSamples());
 
-  // update Filters
-  updateFilters();
+  // the stages are placed in the float and double chains by precision, a new precision places them again
+  const auto isDouble = std::is_same_v<SampleType, double>;
+  const auto precision = precisionMode.load();
+  if (isDouble != doubleProcessing || precision != activePrecisionMode) {
+    doubleProcessing = isDouble;
+    activePrecisionMode = precision;
+    resetFilterDesign();
+  }
+
+  const auto engine = filterEngine.load();
+  if (engine != activeFilterEngine) {
+    // the engine that takes over starts from silence, like after prepareToPlay
+    activeFilterEngine = engine;
+    resetFilterDesign();
+  }
+
+  const auto smoothing = isSmoothingEnabled();
+  if (smoothing != smoothingActive) {
+    // whichever path takes over has to redesign every stage from the current parameters
+    smoothingActive = smoothing;
+    resetFilterDesign();
+  }
+
+  const auto oversampling = oversamplingParameter.getIndex();
+  if (oversampling != activeOversampling) {
+    setOversampling(oversampling);
+  }
+
+  const auto linearPhase = linearPhaseParameter.get();
+  if (linearPhase != linearPhaseActive) {
+    linearPhaseActive = linearPhase;
+    linearPhaseFilter.setActive(linearPhase);
+
+    // the mode that takes over starts from silence, like after prepareToPlay
+    if (linearPhase) {
+      linearPhaseFilter.reset();
+    } else {
+      setOversampling(activeOversampling);
+    }
+  }
+
+  const auto program = requestedProgram.load();
+  if (program != activeProgram) {
+    activeProgram = program;
+    switchProgram();
+  }
 
   // This is the place where you'd normally do the guts of your plugin's
   // audio processing...
-  juce::dsp::AudioBlock<float> block(buffer);
-  auto leftBlock = block.getSingleChannelBlock(0);
-  auto rightBlock = block.getSingleChannelBlock(1);
+  juce::dsp::AudioBlock<SampleType> block(buffer);
+  inputAnalyzerFifo.push(block);
+
+  // once the input has been silent for longer than the tail, the filters have nothing left to say
+  updateTailLength();
+  if (!isSilent(buffer)) {
+    silentSamples = 0;
+  } else if (silentSamples >= tailLengthInSamples) {
+    if (!idle) {
+      idle = true;
+      flushState();
+    }
+    outputAnalyzerFifo.push(block);
+    return;
+  } else {
+    silentSamples += buffer.getNumSamples();
+  }
+
+  if (idle) {
+    // parameters may have moved while idle, start from them like after prepareToPlay
+    idle = false;
+    resetFilterDesign();
+  }
+
+  // only a flag, a sleeping editor looks at it on its own timer
+  editorWakeUp.request();
+
+  auto *oversampler = getOversampler<SampleType>(activeOversampling);
+
+  if (linearPhaseActive) {
+    processLinearPhase(block);
+  } else if (oversampler == nullptr) {
+    processChain(block);
+  } else {
+    auto oversampledBlock = oversampler->processSamplesUp(block);
+    processChain(oversampledBlock);
+    oversampler->processSamplesDown(block);
+  }
+
+  outputAnalyzerFifo.push(block);
+}
+
+template <typename SampleType>
+juce::dsp::Oversampling<SampleType> *SimpleEQAudioProcessor::getOversampler(int index) noexcept
+{
+  if constexpr (std::is_same_v<SampleType, double>) {
+    return doubleOversamplers[static_cast<size_t>(index)].get();
+  } else {
+    return oversamplers[static_cast<size_t>(index)].get();
+  }
+}
+
+template <typename SampleType>
+void SimpleEQAudioProcessor::processChain(juce::dsp::AudioBlock<SampleType> &block)
+{
+  Profiler::ScopedSection filters {profiler, Profiler::Filters};
+
+  // while a program fades out, it needs the input before the block is overwritten
+  const auto fadeSamples = juce::jmin(static_cast<size_t>(juce::jmax(0, fadeRemaining)), block.getNumSamples());
+  juce::dsp::AudioBlock<SampleType> outgoing;
+
+  if (fadeSamples > 0) {
+    if constexpr (std::is_same_v<SampleType, double>) {
+      outgoing = juce::dsp::AudioBlock<double>(doubleFadeScratch);
+    } else {
+      outgoing = juce::dsp::AudioBlock<float>(fadeScratch);
+    }
+    outgoing = outgoing.getSubsetChannelBlock(0, block.getNumChannels()).getSubBlock(0, fadeSamples);
+    outgoing.copyFrom(block.getSubBlock(0, fadeSamples));
+  }
+
+  if (activeFilterEngine == FilterEngine::StateVariable) {
+    processStateVariable(block);
+  } else if (smoothingActive) {
+    processSmoothed(block);
+  } else {
+    // update Filters, this is a no-op unless a parameter moved
+    updateFilters();
+    processStages(block);
+  }
+
+  if (fadeSamples > 0) {
+    processFade(block, outgoing);
+  }
+}
+
+/**
+ * @brief Copy a block into a buffer of another precision, which has room for at least as many channels and samples
+*/
+template <typename Source, typename Destination>
+static void copyConverted(const juce::dsp::AudioBlock<Source> &source, juce::dsp::AudioBlock<Destination> &destination) noexcept
+{
+  for (size_t ch = 0; ch < source.getNumChannels(); ch++) {
+    const auto *in = source.getChannelPointer(ch);
+    auto *out = destination.getChannelPointer(ch);
+    for (size_t i = 0; i < source.getNumSamples(); i++) {
+      out[i] = static_cast<Destination>(in[i]);
+    }
+  }
+}
+
+/**
+ * @brief Run a float and a double chain over the block, the double stages first
+ * @param conversion Room for a double copy of a float block
+*/
+template <typename SampleType>
+static void processChainPair(MultiChannelChain &single, DoubleMultiChannelChain &precise, 
+                             juce::AudioBuffer<double> &conversion, juce::dsp::AudioBlock<SampleType> &block) noexcept
+{
+  if constexpr (std::is_same_v<SampleType, double>) {
+    precise.process(juce::dsp::ProcessContextReplacing<double>(block));
+  } else {
+    if (precise.getNumActiveSections() > 0) {
+      auto converted = juce::dsp::AudioBlock<double>(conversion).getSubsetChannelBlock(0, block.getNumChannels())
+                                                                .getSubBlock(0, block.getNumSamples());
+      copyConverted(block, converted);
+      precise.process(juce::dsp::ProcessContextReplacing<double>(converted));
+      copyConverted(converted, block);
+    }
 
-  juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-  juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+    single.process(juce::dsp::ProcessContextReplacing<float>(block));
+  }
+}
+
+template <typename SampleType>
+void SimpleEQAudioProcessor::processStages(juce::dsp::AudioBlock<SampleType> &block) noexcept
+{
+  processChainPair(chain, doubleChain, doubleScratch, block);
+}
+
+template <typename SampleType>
+void SimpleEQAudioProcessor::processFade(juce::dsp::AudioBlock<SampleType> &block, juce::dsp::AudioBlock<SampleType> &outgoing) noexcept
+{
+  processChainPair(fadeChain, doubleFadeChain, doubleScratch, outgoing);
+
+  // linear crossfade, the gain of the incoming program continues where the last block left it
+  const auto step = static_cast<SampleType>(1) / static_cast<SampleType>(fadeLength);
+  const auto start = static_cast<SampleType>(fadeLength - fadeRemaining) * step;
+
+  for (size_t ch = 0; ch < outgoing.getNumChannels(); ch++) {
+    auto *incoming = block.getChannelPointer(ch);
+    const auto *fading = outgoing.getChannelPointer(ch);
+    auto gain = start;
+
+    for (size_t i = 0; i < outgoing.getNumSamples(); i++) {
+      gain += step;
+      incoming[i] = fading[i] + (incoming[i] - fading[i]) * gain;
+    }
+  }
+
+  fadeRemaining -= static_cast<int>(outgoing.getNumSamples());
+}
+
+void SimpleEQAudioProcessor::switchProgram() noexcept
+{
+  const auto &settings = presetBank.getSettings(activeProgram);
+
+  // the parameters may have been read before the program was requested, compare them against the program again
+  snapshotVersion = ChainSettingsSnapshot::noVersion;
+
+  // the linear-phase filter follows the parameters on its own, and an idle chain is redesigned when it resumes
+  if (linearPhaseActive || idle) {
+    return;
+  }
+
+  // the state variable filters glide to the program instead of crossfading two chains
+  if (activeFilterEngine == FilterEngine::StateVariable) {
+    programGlideRemaining = juce::jmax(1, juce::roundToInt(programFadeSeconds * processingSampleRate));
+    return;
+  }
+
+  // the outgoing program keeps ringing in the fade chains, a fade that is still running is cut short
+  std::swap(chain, fadeChain);
+  std::swap(doubleChain, doubleFadeChain);
+  fadeLength = juce::jmax(1, juce::roundToInt(programFadeSeconds * processingSampleRate));
+  fadeRemaining = fadeLength;
+
+  chain.reset();
+  doubleChain.reset();
+  for (size_t stage = 0; stage < maxBands; stage++) {
+    chain.setStage(stage, nullptr, 0);
+    doubleChain.setStage(stage, nullptr, 0);
+  }
+  stagesInDouble.fill(false);
+
+  const auto &stages = presetBank.getStages(activeProgram, activeOversampling);
+  for (size_t stage = 0; stage < maxBands; stage++) {
+    updateStage(stage, stages.sections[stage], stages.numSections[stage], 0);
+  }
+
+  // the stages match the program now, only parameters that differ from it are redesigned
+  appliedVersions = settingsTracker.update(settings);
+  smoother.reset(processingSampleRate, settings);
+  appliedSmoothedVersions = smoothedTracker.update(settings);
+}
+
+template <typename SampleType>
+void SimpleEQAudioProcessor::processStateVariable(juce::dsp::AudioBlock<SampleType> &block) noexcept
+{
+  SVFFilterChain<SampleType> *stateVariable = nullptr;
+  if constexpr (std::is_same_v<SampleType, double>) {
+    stateVariable = &doubleStateVariableChain;
+  } else {
+    stateVariable = &stateVariableChain;
+  }
+
+  // after a reset the chain jumps to the parameters, later changes move it with a ramp in smoothing mode
+  const auto jump = stateVariableVersion == ChainSettingsSnapshot::noVersion;
+
+  ChainSettings chainSettings;
+  if (chainSettingsSnapshot.readIfChanged(stateVariableVersion, chainSettings)) {
+    Profiler::ScopedSection coefficients {profiler, Profiler::Coefficients};
+    auto rampLength = smoothingActive ? juce::roundToInt(ChainSmoother::rampLengthInSeconds * processingSampleRate) : 0;
+    rampLength = juce::jmax(rampLength, programGlideRemaining);
+    setStateVariableChain(*stateVariable, chainSettings, processingSampleRate, jump ? 0 : static_cast<size_t>(rampLength));
+  }
+
+  programGlideRemaining = juce::jmax(0, programGlideRemaining - static_cast<int>(block.getNumSamples()));
+  stateVariable->process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+}
+
+template <typename SampleType>
+void SimpleEQAudioProcessor::processLinearPhase(juce::dsp::AudioBlock<SampleType> &block) noexcept
+{
+  Profiler::ScopedSection filters {profiler, Profiler::Filters};
+
+  if constexpr (std::is_same_v<SampleType, double>) {
+    // juce::dsp::Convolution only runs in single precision
+    auto single = juce::dsp::AudioBlock<float>(floatScratch).getSubsetChannelBlock(0, block.getNumChannels())
+                                                            .getSubBlock(0, block.getNumSamples());
+    copyConverted(block, single);
+    linearPhaseFilter.process(juce::dsp::ProcessContextReplacing<float>(single));
+    copyConverted(single, block);
+  } else {
+    linearPhaseFilter.process(juce::dsp::ProcessContextReplacing<float>(block));
+  }
+}
+
+void SimpleEQAudioProcessor::resetFilterDesign() noexcept
+{
+  chain.reset();
+  doubleChain.reset();
+  fadeRemaining = 0;
+
+  stateVariableChain.reset();
+  doubleStateVariableChain.reset();
+  stateVariableVersion = ChainSettingsSnapshot::noVersion;
+  programGlideRemaining = 0;
+
+  settingsTracker.invalidate();
+  snapshotVersion = ChainSettingsSnapshot::noVersion;
 
-  leftChain.process(leftContext);
-  rightChain.process(rightContext);
+  smoother.reset(processingSampleRate, chainSettingsSnapshot.read());
+  smoothedTracker.invalidate();
+  samplesUntilSmoothingUpdate = 0;
+}
+
+void SimpleEQAudioProcessor::setOversampling(int index) noexcept
+{
+  // a factor without an oversampler means prepareToPlay hasn't run yet
+  if (index > 0 && oversamplers[static_cast<size_t>(index)] == nullptr) {
+    return;
+  }
+
+  activeOversampling = index;
+  processingSampleRate = getSampleRate() * (1 << index);
+
+  if (auto *oversampler = oversamplers[static_cast<size_t>(index)].get()) {
+    oversampler->reset();
+  }
+  if (auto *oversampler = doubleOversamplers[static_cast<size_t>(index)].get()) {
+    oversampler->reset();
+  }
+  linearPhaseFilter.setDesignSampleRate(processingSampleRate);
+
+  // the state of the chain belongs to the old rate
+  resetFilterDesign();
+}
+
+template <typename SampleType>
+bool SimpleEQAudioProcessor::isSilent(const juce::AudioBuffer<SampleType> &buffer) const noexcept
+{
+  const auto numChannels = juce::jmin(buffer.getNumChannels(), getTotalNumInputChannels());
+
+  for (int ch = 0; ch < numChannels; ch++) {
+    if (buffer.getMagnitude(ch, 0, buffer.getNumSamples()) > silenceThreshold) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void SimpleEQAudioProcessor::flushState() noexcept
+{
+  chain.reset();
+  doubleChain.reset();
+  fadeRemaining = 0;
+  stateVariableChain.reset();
+  doubleStateVariableChain.reset();
+  linearPhaseFilter.reset();
+
+  for (auto &oversampler : oversamplers) {
+    if (oversampler != nullptr) {
+      oversampler->reset();
+    }
+  }
+  for (auto &oversampler : doubleOversamplers) {
+    if (oversampler != nullptr) {
+      oversampler->reset();
+    }
+  }
+}
+
+double SimpleEQAudioProcessor::getFilterSampleRate() const noexcept
+{
+  return getSampleRate() * (1 << oversamplingParameter.getIndex());
+}
+
+void SimpleEQAudioProcessor::updateLatency()
+{
+  if (linearPhaseParameter.get()) {
+    setLatencySamples(linearPhaseLatency);
+  } else {
+    setLatencySamples(oversamplingLatencies[static_cast<size_t>(oversamplingParameter.getIndex())]);
+  }
+}
+
+void SimpleEQAudioProcessor::parameterValueChanged(int parameterIndex, float newValue)
+{
+  juce::ignoreUnused(parameterIndex, newValue);
+
+  // the audio thread switches on its next block, the host learns about the new latency right away. Reporting
+  // it notifies the wrapper, which posts messages, so a change from any other thread waits for prepareToPlay.
+  // Without a message manager, e.g. in the tests, there is no other thread to defer to.
+  const auto *messageManager = juce::MessageManager::getInstanceWithoutCreating();
+  if (messageManager == nullptr || messageManager->isThisTheMessageThread()) {
+    updateLatency();
+  }
+}
+
+template <typename SampleType>
+void SimpleEQAudioProcessor::processSmoothed(juce::dsp::AudioBlock<SampleType> &block)
+{
+  smoother.setTarget(chainSettingsSnapshot.read());
+
+  const auto numSamples = block.getNumSamples();
+  size_t position = 0;
+
+  // the grid runs across block boundaries, so the interpolation does not depend on the host buffer size
+  while (position < numSamples) {
+    if (samplesUntilSmoothingUpdate == 0) {
+      // design the coefficients for the end of the next sub-block and interpolate towards them
+      auto chainSettings = smoother.skip(ChainSmoother::updateInterval);
+      applyChainSettings(chainSettings, smoothedTracker.update(chainSettings), appliedSmoothedVersions, 
+                         static_cast<size_t>(ChainSmoother::updateInterval));
+      samplesUntilSmoothingUpdate = ChainSmoother::updateInterval;
+    }
+
+    const auto count = juce::jmin(numSamples - position, static_cast<size_t>(samplesUntilSmoothingUpdate));
+    auto subBlock = block.getSubBlock(position, count);
+    processStages(subBlock);
+
+    position += count;
+    samplesUntilSmoothingUpdate -= static_cast<int>(count);
+  }
+}
+
+bool SimpleEQAudioProcessor::isSmoothingEnabled() const noexcept
+{
+  return smoothingParameter.get();
 }
 
 bool SimpleEQAudioProcessor::hasEditor() const 
@@ -171,8 +710,28 @@ void SimpleEQAudioProcessor::getStateInformation(juce::MemoryBlock &destData)
   // You should use this method to store your parameters in the memory block.
   // You could do that either as raw data, or use the XML or ValueTree classes
   // as intermediaries to make it easy to save and load complex data.
-  juce::MemoryOutputStream stream(destData, true);
-  apvts.state.writeToStream(stream);
+  juce::MemoryOutputStream stream(destData, false);
+  const auto &parameters = getParameters();
+
+  stream.writeInt(stateMagic);
+  stream.writeInt(stateVersion);
+  stream.writeInt(requestedProgram.load());
+  stream.writeInt(parameters.size());
+
+  for (auto *parameter : parameters) {
+    const auto *withID = dynamic_cast<juce::AudioProcessorParameterWithID *>(parameter);
+    stream.writeInt(static_cast<int>(getStateKey(withID != nullptr ? withID->paramID : juce::String())));
+    stream.writeFloat(parameter->getValue());
+  }
+}
+
+juce::uint32 SimpleEQAudioProcessor::getStateKey(const juce::String &parameterID) noexcept
+{
+  juce::uint32 hash = 2166136261u;
+  for (auto *byte = parameterID.toRawUTF8(); *byte != 0; byte++) {
+    hash = (hash ^ static_cast<juce::uint8>(*byte)) * 16777619u;
+  }
+  return hash;
 }
 
 void SimpleEQAudioProcessor::setStateInformation(const void *data, int sizeInBytes) 
@@ -180,10 +739,60 @@ void SimpleEQAudioProcessor::setStateInformation(const void *data, int sizeInByt
   // You should use this method to restore your parameters from this memory
   // block, whose contents will have been created by the getStateInformation()
   // call.
+  juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+  constexpr int headerSize = 4 * static_cast<int>(sizeof(int));
+
+  if (sizeInBytes >= headerSize && stream.readInt() == stateMagic) {
+    const auto version = stream.readInt();
+    const auto program = stream.readInt();
+    const auto &parameters = getParameters();
+    const auto numStored = stream.readInt();
+
+    if (version == 1) {
+      // the layout hasn't changed its order since version 1 was written, only parameters were added after it
+      const auto numParameters = juce::jmin(numStored, parameters.size(), (sizeInBytes - headerSize) / static_cast<int>(sizeof(float)));
+      for (int i = 0; i < numParameters; i++) {
+        parameters[i]->setValueNotifyingHost(stream.readFloat());
+      }
+    } else if (version == stateVersion) {
+      std::vector<juce::uint32> keys;
+      for (auto *parameter : parameters) {
+        const auto *withID = dynamic_cast<juce::AudioProcessorParameterWithID *>(parameter);
+        keys.push_back(getStateKey(withID != nullptr ? withID->paramID : juce::String()));
+      }
+
+      // parameters that didn't exist when the state was written keep their defaults, removed ones are skipped
+      constexpr auto entrySize = static_cast<int>(sizeof(int) + sizeof(float));
+      const auto numEntries = juce::jmin(numStored, (sizeInBytes - headerSize) / entrySize);
+      for (int i = 0; i < numEntries; i++) {
+        const auto key = static_cast<juce::uint32>(stream.readInt());
+        const auto value = stream.readFloat();
+
+        const auto match = std::find(keys.begin(), keys.end(), key);
+        if (match != keys.end()) {
+          parameters[static_cast<int>(match - keys.begin())]->setValueNotifyingHost(value);
+        }
+      }
+    } else {
+      // written by a newer version of the plugin
+      return;
+    }
+
+    chainSettingsSnapshot.publish();
+
+    // the audio thread fades into the program and redesigns whatever was changed after it was loaded
+    if (juce::isPositiveAndBelow(program, presetBank.getNumPrograms())) {
+      requestedProgram.store(program);
+    }
+    return;
+  }
+
   auto tree = juce::ValueTree::readFromData(data, static_cast<size_t>(sizeInBytes));
   if (tree.isValid()) {
     apvts.replaceState(tree);
-    
+
+    // replaceState may defer some of the parameter updates, make sure the snapshot has the new values
+    chainSettingsSnapshot.publish();
   }
 }
 
@@ -199,56 +808,542 @@ ChainSettings getChainSettings(juce::AudioProcessorValueTreeState &apvts)
   settings.lowCutSlope = static_cast<Slope>(apvts.getRawParameterValue("LowCut Slope")->load());
   settings.highCutSlope = static_cast<Slope>(apvts.getRawParameterValue("HighCut Slope")->load());
 
+  for (size_t i = 0; i < numExtraBands; i++) {
+    auto &band = settings.bands[i];
+    band.type = static_cast<BandType>(apvts.getRawParameterValue(getBandParameterID(i, "Type"))->load());
+    band.freq = apvts.getRawParameterValue(getBandParameterID(i, "Freq"))->load();
+    band.gainInDecibels = apvts.getRawParameterValue(getBandParameterID(i, "Gain"))->load();
+    band.quality = apvts.getRawParameterValue(getBandParameterID(i, "Quality"))->load();
+  }
+
   return settings;
 }
 
-Coefficients makePeakFilter(const ChainSettings &chainSettings, double sampleRate) 
+/**
+ * @brief Name of a chain parameter, only turned into its ID by the visitors that need one
+*/
+struct ChainParameterName {
+  const char *name;
+  size_t band {numExtraBands};
+
+  juce::String getID() const { return band < numExtraBands ? getBandParameterID(band, name) : juce::String(name); }
+};
+
+/**
+ * @brief Call visit(name, field) for every chain parameter and the field of the settings it feeds
+*/
+template <typename Visitor>
+static void visitChainParameters(ChainSettings &settings, Visitor &&visit)
+{
+  visit(ChainParameterName {"LowCut Freq"}, settings.lowCutFreq);
+  visit(ChainParameterName {"HighCut Freq"}, settings.highCutFreq);
+  visit(ChainParameterName {"Peak Freq"}, settings.peakFreq);
+  visit(ChainParameterName {"Peak Gain"}, settings.peakGainInDecibels);
+  visit(ChainParameterName {"Peak Quality"}, settings.peakQuality);
+  visit(ChainParameterName {"LowCut Slope"}, settings.lowCutSlope);
+  visit(ChainParameterName {"HighCut Slope"}, settings.highCutSlope);
+
+  for (size_t i = 0; i < numExtraBands; i++) {
+    auto &band = settings.bands[i];
+    visit(ChainParameterName {"Type", i}, band.type);
+    visit(ChainParameterName {"Freq", i}, band.freq);
+    visit(ChainParameterName {"Gain", i}, band.gainInDecibels);
+    visit(ChainParameterName {"Quality", i}, band.quality);
+  }
+}
+
+template <typename Field>
+static float toParameterValue(Field field)
 {
-  return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 
-                                                             chainSettings.peakFreq, 
-                                                             chainSettings.peakQuality, 
-                                                             juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels));
+  if constexpr (std::is_enum_v<Field>) {
+    return static_cast<float>(static_cast<int>(field));
+  } else {
+    return field;
+  }
 }
 
-void SimpleEQAudioProcessor::updatePeakFilter(const ChainSettings &chainSettings) 
+template <typename Field>
+static Field fromParameterValue(float value)
 {
-  auto peakCoefficients = makePeakFilter(chainSettings, getSampleRate());
-  updateCoefficients(leftChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-  updateCoefficients(rightChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
+  if constexpr (std::is_enum_v<Field>) {
+    return static_cast<Field>(juce::roundToInt(value));
+  } else {
+    return value;
+  }
 }
 
-void updateCoefficients(Coefficients &old, const Coefficients &replacements) 
+ChainParameters getChainParameters(juce::AudioProcessorValueTreeState &apvts)
 {
-  *old = *replacements;
+  ChainParameters parameters;
+  ChainSettings settings;
+  visitChainParameters(settings, [&](const ChainParameterName &name, auto &) {
+    parameters.push_back(apvts.getParameter(name.getID()));
+  });
+  return parameters;
 }
 
-void SimpleEQAudioProcessor::updateLowCutFilters(const ChainSettings &chainSettings) 
+void setChainSettings(juce::AudioProcessorValueTreeState &apvts, const ChainSettings &settings)
 {
-  auto lowCutCoefficients = makeLowCutFilter(chainSettings, getSampleRate());
-  auto &leftLowCut = leftChain.get<ChainPositions::LowCut>();
-  auto &rightLowCut = rightChain.get<ChainPositions::LowCut>();
-  
-  updateCutFilters(leftLowCut, lowCutCoefficients, chainSettings.lowCutSlope);
-  updateCutFilters(rightLowCut, lowCutCoefficients, chainSettings.lowCutSlope);
+  setChainSettings(getChainParameters(apvts), settings);
+}
+
+void setChainSettings(const ChainParameters &parameters, const ChainSettings &settings) noexcept
+{
+  auto copy = settings;
+  size_t index = 0;
+  visitChainParameters(copy, [&](const ChainParameterName &, auto &field) {
+    auto *parameter = parameters[index++];
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(toParameterValue(field)));
+  });
+}
+
+ChainSettings quantizeChainSettings(juce::AudioProcessorValueTreeState &apvts, const ChainSettings &settings)
+{
+  auto quantized = settings;
+  visitChainParameters(quantized, [&](const ChainParameterName &name, auto &field) {
+    const auto *parameter = apvts.getParameter(name.getID());
+    const auto value = parameter->convertFrom0to1(parameter->convertTo0to1(toParameterValue(field)));
+    field = fromParameterValue<std::decay_t<decltype(field)>>(value);
+  });
+  return quantized;
+}
+
+juce::String getBandParameterID(size_t extraBand, const juce::String &name)
+{
+  return "Band " + juce::String(getBandPosition(extraBand) + 1) + " " + name;
+}
+
+ChainVersions ChainSettingsTracker::update(const ChainSettings &settings) noexcept
+{
+  if (!valid || settings.lowCutFreq != last.lowCutFreq || settings.lowCutSlope != last.lowCutSlope) {
+    ++versions.lowCut;
+  }
+  if (!valid || settings.peakFreq != last.peakFreq || settings.peakGainInDecibels != last.peakGainInDecibels 
+      || settings.peakQuality != last.peakQuality) {
+    ++versions.peak;
+  }
+  if (!valid || settings.highCutFreq != last.highCutFreq || settings.highCutSlope != last.highCutSlope) {
+    ++versions.highCut;
+  }
+
+  for (size_t i = 0; i < numExtraBands; i++) {
+    const auto &band = settings.bands[i];
+    const auto &lastBand = last.bands[i];
+    if (!valid || band.type != lastBand.type || band.freq != lastBand.freq 
+        || band.gainInDecibels != lastBand.gainInDecibels || band.quality != lastBand.quality) {
+      ++versions.bands[i];
+    }
+  }
+
+  last = settings;
+  valid = true;
+
+  return versions;
+}
+
+void ChainSettingsTracker::invalidate() noexcept
+{
+  valid = false;
+}
+
+void ChainSmoother::reset(double sampleRate, const ChainSettings &settings) noexcept
+{
+  lowCutFreq.reset(sampleRate, rampLengthInSeconds);
+  highCutFreq.reset(sampleRate, rampLengthInSeconds);
+  peakFreq.reset(sampleRate, rampLengthInSeconds);
+  peakGainInDecibels.reset(sampleRate, rampLengthInSeconds);
+  peakQuality.reset(sampleRate, rampLengthInSeconds);
+
+  lowCutFreq.setCurrentAndTargetValue(settings.lowCutFreq);
+  highCutFreq.setCurrentAndTargetValue(settings.highCutFreq);
+  peakFreq.setCurrentAndTargetValue(settings.peakFreq);
+  peakGainInDecibels.setCurrentAndTargetValue(settings.peakGainInDecibels);
+  peakQuality.setCurrentAndTargetValue(settings.peakQuality);
+
+  lowCutSlope = settings.lowCutSlope;
+  highCutSlope = settings.highCutSlope;
+
+  for (size_t i = 0; i < numExtraBands; i++) {
+    auto &band = bands[i];
+    band.freq.reset(sampleRate, rampLengthInSeconds);
+    band.gainInDecibels.reset(sampleRate, rampLengthInSeconds);
+    band.quality.reset(sampleRate, rampLengthInSeconds);
+
+    band.freq.setCurrentAndTargetValue(settings.bands[i].freq);
+    band.gainInDecibels.setCurrentAndTargetValue(settings.bands[i].gainInDecibels);
+    band.quality.setCurrentAndTargetValue(settings.bands[i].quality);
+    band.type = settings.bands[i].type;
+  }
+}
+
+void ChainSmoother::setTarget(const ChainSettings &settings) noexcept
+{
+  lowCutFreq.setTargetValue(settings.lowCutFreq);
+  highCutFreq.setTargetValue(settings.highCutFreq);
+  peakFreq.setTargetValue(settings.peakFreq);
+  peakGainInDecibels.setTargetValue(settings.peakGainInDecibels);
+  peakQuality.setTargetValue(settings.peakQuality);
+
+  lowCutSlope = settings.lowCutSlope;
+  highCutSlope = settings.highCutSlope;
+
+  for (size_t i = 0; i < numExtraBands; i++) {
+    bands[i].freq.setTargetValue(settings.bands[i].freq);
+    bands[i].gainInDecibels.setTargetValue(settings.bands[i].gainInDecibels);
+    bands[i].quality.setTargetValue(settings.bands[i].quality);
+    bands[i].type = settings.bands[i].type;
+  }
+}
+
+ChainSettings ChainSmoother::skip(int numSamples) noexcept
+{
+  ChainSettings settings;
+
+  settings.lowCutFreq = lowCutFreq.skip(numSamples);
+  settings.highCutFreq = highCutFreq.skip(numSamples);
+  settings.peakFreq = peakFreq.skip(numSamples);
+  settings.peakGainInDecibels = peakGainInDecibels.skip(numSamples);
+  settings.peakQuality = peakQuality.skip(numSamples);
+  settings.lowCutSlope = lowCutSlope;
+  settings.highCutSlope = highCutSlope;
+
+  for (size_t i = 0; i < numExtraBands; i++) {
+    settings.bands[i].freq = bands[i].freq.skip(numSamples);
+    settings.bands[i].gainInDecibels = bands[i].gainInDecibels.skip(numSamples);
+    settings.bands[i].quality = bands[i].quality.skip(numSamples);
+    settings.bands[i].type = bands[i].type;
+  }
+
+  return settings;
+}
+
+template <typename SampleType>
+typename BasicFilter<SampleType>::CoefficientsPtr makePeakFilter(const ChainSettings &chainSettings, double sampleRate) 
+{
+  return juce::dsp::IIR::Coefficients<SampleType>::makePeakFilter(sampleRate, 
+                                                                  static_cast<SampleType>(chainSettings.peakFreq), 
+                                                                  static_cast<SampleType>(chainSettings.peakQuality), 
+                                                                  juce::Decibels::decibelsToGain(static_cast<SampleType>(chainSettings.peakGainInDecibels)));
+}
+
+template <typename SampleType>
+BasicSectionCoefficients<SampleType> designPeakFilter(const ChainSettings &chainSettings, double sampleRate) 
+{
+  return filter_design::designPeak<SampleType>(sampleRate, 
+                                                chainSettings.peakFreq, 
+                                                chainSettings.peakQuality, 
+                                                juce::Decibels::decibelsToGain(static_cast<double>(chainSettings.peakGainInDecibels)));
+}
+
+/**
+ * @brief Samples a section needs to decay by tailDecayDecibels, from the radius of its slowest pole
+*/
+static double getDecayLengthInSamples(const BasicSectionCoefficients<double> &raw)
+{
+  const auto coefficients = BiquadCoefficients<double>::fromRaw(raw);
+  if (coefficients.isIdentity()) {
+    return 0.0;
+  }
+
+  auto radius = getPoleRadius(coefficients);
+
+  // the two taps of the numerator delay the input even without feedback
+  constexpr double numeratorLength = 2.0;
+  if (radius <= 0.0) {
+    return numeratorLength;
+  }
+
+  // poles on the unit circle would never decay, the designs the parameters allow stay well inside it
+  radius = juce::jmin(radius, 1.0 - 1.0e-7);
+  return std::log(juce::Decibels::decibelsToGain(tailDecayDecibels)) / std::log(radius) + numeratorLength;
 }
 
-void SimpleEQAudioProcessor::updateHighCutFilters(const ChainSettings &chainSettings) 
+double calculateTailLengthSeconds(const ChainSettings &chainSettings, double sampleRate)
 {
-  auto highCutCoefficients = makeHighCutFilter(chainSettings, getSampleRate());
-  auto &leftHighCut = leftChain.get<ChainPositions::HighCut>();
-  auto &rightHighCut = rightChain.get<ChainPositions::HighCut>();
+  // the tails of a cascade add up at worst, each section rings on the decay of the ones before it
+  auto samples = 0.0;
 
-  updateCutFilters(leftHighCut, highCutCoefficients, chainSettings.highCutSlope);
-  updateCutFilters(rightHighCut, highCutCoefficients, chainSettings.highCutSlope);
+  const auto lowCut = designLowCutFilter<double>(chainSettings, sampleRate);
+  for (size_t i = 0; i < getNumSections(chainSettings.lowCutSlope); i++) {
+    samples += getDecayLengthInSamples(lowCut[i]);
+  }
+
+  const auto highCut = designHighCutFilter<double>(chainSettings, sampleRate);
+  for (size_t i = 0; i < getNumSections(chainSettings.highCutSlope); i++) {
+    samples += getDecayLengthInSamples(highCut[i]);
+  }
+
+  samples += getDecayLengthInSamples(designPeakFilter<double>(chainSettings, sampleRate));
+
+  for (const auto &band : chainSettings.bands) {
+    if (getNumSections(band) > 0) {
+      samples += getDecayLengthInSamples(designBand<double>(band, sampleRate));
+    }
+  }
+
+  return samples / sampleRate;
+}
+
+template <typename SampleType>
+BasicCutCoefficients<SampleType> designLowCutFilter(const ChainSettings &chainSettings, double sampleRate) 
+{
+  BasicCutCoefficients<SampleType> coefficients {};
+  filter_design::designButterworthHighPass(coefficients, 2 * (chainSettings.lowCutSlope + 1), sampleRate, chainSettings.lowCutFreq);
+  return coefficients;
+}
+
+template <typename SampleType>
+BasicCutCoefficients<SampleType> designHighCutFilter(const ChainSettings &chainSettings, double sampleRate) 
+{
+  BasicCutCoefficients<SampleType> coefficients {};
+  filter_design::designButterworthLowPass(coefficients, 2 * (chainSettings.highCutSlope + 1), sampleRate, chainSettings.highCutFreq);
+  return coefficients;
+}
+
+template <typename SampleType>
+BasicSectionCoefficients<SampleType> designBand(const BandSettings &band, double sampleRate) 
+{
+  using ArrayCoefficients = juce::dsp::IIR::ArrayCoefficients<SampleType>;
+  const auto freq = static_cast<SampleType>(band.freq);
+  const auto quality = static_cast<SampleType>(band.quality);
+  const auto gain = juce::Decibels::decibelsToGain(static_cast<SampleType>(band.gainInDecibels));
+
+  // the shelves and the notch come from JUCE's array designs, which don't allocate either
+  switch (band.type) {
+    case BandType::Peak:
+      return filter_design::designPeak<SampleType>(sampleRate, band.freq, band.quality, 
+                                                   juce::Decibels::decibelsToGain(static_cast<double>(band.gainInDecibels)));
+    case BandType::LowShelf:
+      return ArrayCoefficients::makeLowShelf(sampleRate, freq, quality, gain);
+    case BandType::HighShelf:
+      return ArrayCoefficients::makeHighShelf(sampleRate, freq, quality, gain);
+    case BandType::Notch:
+      return ArrayCoefficients::makeNotch(sampleRate, freq, quality);
+    case BandType::LowCut:
+      return filter_design::designHighPass<SampleType>(sampleRate, band.freq, band.quality);
+    case BandType::HighCut:
+      return filter_design::designLowPass<SampleType>(sampleRate, band.freq, band.quality);
+    case BandType::Off:
+      break;
+  }
+
+  return {1, 0, 0, 1, 0, 0};
+}
+
+/**
+ * @brief Response of an extra band in the state variable chain, the single section cuts use the band's quality
+*/
+template <typename SampleType>
+static typename SVFFilterChain<SampleType>::Response getStateVariableResponse(BandType type) noexcept
+{
+  using Response = typename SVFFilterChain<SampleType>::Response;
+
+  switch (type) {
+    case BandType::Peak:
+      return Response::Peak;
+    case BandType::LowShelf:
+      return Response::LowShelf;
+    case BandType::HighShelf:
+      return Response::HighShelf;
+    case BandType::Notch:
+      return Response::Notch;
+    case BandType::LowCut:
+      return Response::HighPass;
+    case BandType::HighCut:
+      return Response::LowPass;
+    case BandType::Off:
+      break;
+  }
+
+  return Response::Off;
+}
+
+template <typename SampleType>
+void setStateVariableChain(SVFFilterChain<SampleType> &chain, const ChainSettings &chainSettings, double sampleRate, 
+                           size_t rampLength) noexcept
+{
+  using Response = typename SVFFilterChain<SampleType>::Response;
+
+  chain.setStage(ChainPositions::LowCut, {Response::HighPass, 2 * (chainSettings.lowCutSlope + 1), chainSettings.lowCutFreq}, 
+                 sampleRate, rampLength);
+  chain.setStage(ChainPositions::Peak, {Response::Peak, 0, chainSettings.peakFreq, chainSettings.peakQuality, 
+                                        chainSettings.peakGainInDecibels}, sampleRate, rampLength);
+  chain.setStage(ChainPositions::HighCut, {Response::LowPass, 2 * (chainSettings.highCutSlope + 1), chainSettings.highCutFreq}, 
+                 sampleRate, rampLength);
+
+  for (size_t i = 0; i < numExtraBands; i++) {
+    const auto &band = chainSettings.bands[i];
+    chain.setStage(getBandPosition(i), {getStateVariableResponse<SampleType>(band.type), 0, band.freq, band.quality, 
+                                        band.gainInDecibels}, sampleRate, rampLength);
+  }
+}
+
+template Filter::CoefficientsPtr makePeakFilter<float>(const ChainSettings &, double);
+template BasicFilter<double>::CoefficientsPtr makePeakFilter<double>(const ChainSettings &, double);
+template SectionCoefficients designPeakFilter<float>(const ChainSettings &, double);
+template BasicSectionCoefficients<double> designPeakFilter<double>(const ChainSettings &, double);
+template CutCoefficients designLowCutFilter<float>(const ChainSettings &, double);
+template BasicCutCoefficients<double> designLowCutFilter<double>(const ChainSettings &, double);
+template CutCoefficients designHighCutFilter<float>(const ChainSettings &, double);
+template BasicCutCoefficients<double> designHighCutFilter<double>(const ChainSettings &, double);
+template SectionCoefficients designBand<float>(const BandSettings &, double);
+template BasicSectionCoefficients<double> designBand<double>(const BandSettings &, double);
+template void setStateVariableChain<float>(StateVariableChain &, const ChainSettings &, double, size_t) noexcept;
+template void setStateVariableChain<double>(DoubleStateVariableChain &, const ChainSettings &, double, size_t) noexcept;
+
+/**
+ * @brief Carry the state of a stage over to the chain of the other precision, so the audio doesn't click
+*/
+template <typename From, typename To>
+static void moveStageState(const SIMDFilterChain<From> &from, SIMDFilterChain<To> &to, size_t stage) noexcept
+{
+  for (size_t ch = 0; ch < from.getNumChannels(); ch++) {
+    for (size_t section = 0; section < SIMDFilterChain<From>::maxSectionsPerStage; section++) {
+      const auto state = from.getSectionState(ch, stage, section);
+      to.setSectionState(ch, stage, section, {static_cast<To>(state[0]), static_cast<To>(state[1])});
+    }
+  }
+}
+
+bool SimpleEQAudioProcessor::runsInDoublePrecision(size_t stage, const BasicSectionCoefficients<double> *sections, 
+                                                   size_t numSections) const noexcept
+{
+  if (doubleProcessing || activePrecisionMode == PrecisionMode::Double) {
+    return true;
+  }
+  if (activePrecisionMode == PrecisionMode::Single) {
+    return false;
+  }
+
+  // twice the distance to leave double again, so a frequency sitting on the border doesn't flip every update
+  const auto limit = stagesInDouble[stage] ? 2.0 * illConditionedDistance : illConditionedDistance;
+
+  for (size_t i = 0; i < numSections; i++) {
+    if (1.0 - getPoleRadius(BiquadCoefficients<double>::fromRaw(sections[i])) < limit) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename DesignFunction>
+BasicCutCoefficients<double> SimpleEQAudioProcessor::designStage(const CoefficientCache::Key &key, size_t rampLength, 
+                                                                 DesignFunction &&design)
+{
+  // the steps of a smoothing ramp are only used once, they would only push the settled designs out
+  if (rampLength > 0) {
+    return design();
+  }
+
+  BasicCutCoefficients<double> sections;
+  if (!coefficientCache->lookup(key, sections)) {
+    sections = design();
+    coefficientCache->insert(key, sections);
+  }
+  return sections;
+}
+
+void SimpleEQAudioProcessor::updateStage(size_t stage, const BasicCutCoefficients<double> &sections, size_t numSections, 
+                                         size_t rampLength) noexcept
+{
+  if (runsInDoublePrecision(stage, sections.data(), numSections)) {
+    if (!stagesInDouble[stage]) {
+      moveStageState(chain, doubleChain, stage);
+      chain.setStage(stage, nullptr, 0);
+      stagesInDouble[stage] = true;
+    }
+    doubleChain.setStage(stage, sections.data(), numSections, rampLength);
+  } else {
+    if (stagesInDouble[stage]) {
+      moveStageState(doubleChain, chain, stage);
+      doubleChain.setStage(stage, nullptr, 0);
+      stagesInDouble[stage] = false;
+    }
+
+    // the designs round to single precision once, at the end
+    CutCoefficients single {};
+    for (size_t i = 0; i < numSections; i++) {
+      for (size_t c = 0; c < single[i].size(); c++) {
+        single[i][c] = static_cast<float>(sections[i][c]);
+      }
+    }
+    chain.setStage(stage, single.data(), numSections, rampLength);
+  }
+}
+
+void SimpleEQAudioProcessor::updatePeakFilter(const ChainSettings &chainSettings, size_t rampLength) 
+{
+  const CoefficientCache::Key key {ChainPositions::Peak + 1, 0, chainSettings.peakFreq, chainSettings.peakQuality, 
+                                   chainSettings.peakGainInDecibels, processingSampleRate};
+  const auto sections = designStage(key, rampLength, [&] {
+    BasicCutCoefficients<double> peak {};
+    peak[0] = designPeakFilter<double>(chainSettings, processingSampleRate);
+    return peak;
+  });
+  updateStage(ChainPositions::Peak, sections, 1, rampLength);
+}
+
+void SimpleEQAudioProcessor::updateLowCutFilters(const ChainSettings &chainSettings, size_t rampLength) 
+{
+  const CoefficientCache::Key key {ChainPositions::LowCut + 1, static_cast<juce::uint32>(chainSettings.lowCutSlope), 
+                                   chainSettings.lowCutFreq, 0, 0, processingSampleRate};
+  const auto sections = designStage(key, rampLength, [&] { return designLowCutFilter<double>(chainSettings, processingSampleRate); });
+  updateStage(ChainPositions::LowCut, sections, getNumSections(chainSettings.lowCutSlope), rampLength);
+}
+
+void SimpleEQAudioProcessor::updateHighCutFilters(const ChainSettings &chainSettings, size_t rampLength) 
+{
+  const CoefficientCache::Key key {ChainPositions::HighCut + 1, static_cast<juce::uint32>(chainSettings.highCutSlope), 
+                                   chainSettings.highCutFreq, 0, 0, processingSampleRate};
+  const auto sections = designStage(key, rampLength, [&] { return designHighCutFilter<double>(chainSettings, processingSampleRate); });
+  updateStage(ChainPositions::HighCut, sections, getNumSections(chainSettings.highCutSlope), rampLength);
+}
+
+void SimpleEQAudioProcessor::updateBand(size_t band, const BandSettings &bandSettings, size_t rampLength) 
+{
+  // the band types follow the three fixed kinds
+  const CoefficientCache::Key key {ChainPositions::HighCut + 2 + static_cast<juce::uint32>(bandSettings.type), 0, 
+                                   bandSettings.freq, bandSettings.quality, bandSettings.gainInDecibels, processingSampleRate};
+  const auto sections = designStage(key, rampLength, [&] {
+    BasicCutCoefficients<double> section {};
+    section[0] = designBand<double>(bandSettings, processingSampleRate);
+    return section;
+  });
+  updateStage(getBandPosition(band), sections, getNumSections(bandSettings), rampLength);
 }
 
 void SimpleEQAudioProcessor::updateFilters() 
 {
-  auto chainSettings = getChainSettings(apvts);
+  // a single version check when no parameter moved
+  ChainSettings chainSettings;
+  if (!chainSettingsSnapshot.readIfChanged(snapshotVersion, chainSettings)) {
+    return;
+  }
+
+  applyChainSettings(chainSettings, settingsTracker.update(chainSettings), appliedVersions, 0);
+}
+
+void SimpleEQAudioProcessor::applyChainSettings(const ChainSettings &chainSettings, const ChainVersions &versions, 
+                                                ChainVersions &applied, size_t rampLength) 
+{
+  Profiler::ScopedSection coefficients {profiler, Profiler::Coefficients};
+
+  if (versions.lowCut != applied.lowCut) {
+    updateLowCutFilters(chainSettings, rampLength);
+  }
+  if (versions.highCut != applied.highCut) {
+    updateHighCutFilters(chainSettings, rampLength);
+  }
+  if (versions.peak != applied.peak) {
+    updatePeakFilter(chainSettings, rampLength);
+  }
+  for (size_t i = 0; i < numExtraBands; i++) {
+    if (versions.bands[i] != applied.bands[i]) {
+      updateBand(i, chainSettings.bands[i], rampLength);
+    }
+  }
 
-  updateLowCutFilters(chainSettings);
-  updateHighCutFilters(chainSettings);
-  updatePeakFilter(chainSettings);
+  applied = versions;
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout audio_plugin::SimpleEQAudioProcessor::createParameterLayout() 
@@ -298,6 +1393,46 @@ juce::AudioProcessorValueTreeState::ParameterLayout audio_plugin::SimpleEQAudioP
                                                           stringArray, 
                                                           0));                                      
 
+  const juce::StringArray bandTypes {"Off", "Peak", "Low Shelf", "High Shelf", "Notch", "Low Cut", "High Cut"};
+
+  for (size_t i = 0; i < numExtraBands; i++) {
+    layout.add(std::make_unique<juce::AudioParameterChoice>(getBandParameterID(i, "Type"), 
+                                                            getBandParameterID(i, "Type"), 
+                                                            bandTypes, 
+                                                            0));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(getBandParameterID(i, "Freq"), 
+                                                           getBandParameterID(i, "Freq"), 
+                                                           juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.25f), 
+                                                           1000.0f));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(getBandParameterID(i, "Gain"), 
+                                                           getBandParameterID(i, "Gain"), 
+                                                           juce::NormalisableRange<float>(-24.0f, 24.0f, 0.5f, 1.0f), 
+                                                           0.0f));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(getBandParameterID(i, "Quality"), 
+                                                           getBandParameterID(i, "Quality"), 
+                                                           juce::NormalisableRange<float>(0.1f, 10.0f, 0.5f, 1.0f), 
+                                                           1.0f));
+  }
+
+  layout.add(std::make_unique<juce::AudioParameterBool>("Smoothing", 
+                                                        "Smoothing", 
+                                                        false));
+
+  // both change the latency, which can't be reported from the audio thread, so hosts don't automate them
+  layout.add(std::make_unique<juce::AudioParameterChoice>("Oversampling", 
+                                                          "Oversampling", 
+                                                          juce::StringArray {"Off", "2x", "4x"}, 
+                                                          0,
+                                                          juce::AudioParameterChoiceAttributes().withAutomatable(false)));
+
+  layout.add(std::make_unique<juce::AudioParameterBool>("Linear Phase", 
+                                                        "Linear Phase", 
+                                                        false,
+                                                        juce::AudioParameterBoolAttributes().withAutomatable(false)));
+
   return layout;
 }
 
@@ -0,0 +1,132 @@
+#include "SimpleEQ/PresetBank.h"
+#include "SimpleEQ/PluginProcessor.h"
+
+namespace audio_plugin {
+
+struct PresetBank::Program {
+  juce::String name;
+  ChainSettings settings;
+};
+
+namespace {
+
+/**
+ * @brief Settings of the parameters' default values, the starting point of every factory program
+*/
+ChainSettings makeInitSettings()
+{
+  ChainSettings settings;
+  settings.lowCutFreq = 20.f;
+  settings.highCutFreq = 20000.f;
+  settings.peakFreq = 750.f;
+  settings.peakGainInDecibels = 0.f;
+  settings.peakQuality = 1.f;
+  return settings;
+}
+
+std::vector<std::pair<juce::String, ChainSettings>> makeFactoryPrograms()
+{
+  std::vector<std::pair<juce::String, ChainSettings>> factory;
+
+  factory.emplace_back("Init", makeInitSettings());
+
+  auto rumble = makeInitSettings();
+  rumble.lowCutFreq = 80.f;
+  rumble.lowCutSlope = Slope_24;
+  factory.emplace_back("Rumble Filter", rumble);
+
+  auto presence = makeInitSettings();
+  presence.lowCutFreq = 100.f;
+  presence.lowCutSlope = Slope_24;
+  presence.peakFreq = 3000.f;
+  presence.peakGainInDecibels = 4.f;
+  presence.peakQuality = 1.1f;
+  factory.emplace_back("Vocal Presence", presence);
+
+  auto warmth = makeInitSettings();
+  warmth.peakFreq = 200.f;
+  warmth.peakGainInDecibels = 3.f;
+  warmth.peakQuality = 0.6f;
+  warmth.highCutFreq = 14000.f;
+  factory.emplace_back("Warmth", warmth);
+
+  auto mud = makeInitSettings();
+  mud.peakFreq = 350.f;
+  mud.peakGainInDecibels = -4.f;
+  mud.peakQuality = 1.6f;
+  factory.emplace_back("Clear The Mud", mud);
+
+  auto air = makeInitSettings();
+  air.bands[0] = {BandType::HighShelf, 10000.f, 4.f, 0.6f};
+  factory.emplace_back("Air", air);
+
+  auto telephone = makeInitSettings();
+  telephone.lowCutFreq = 400.f;
+  telephone.lowCutSlope = Slope_48;
+  telephone.highCutFreq = 3400.f;
+  telephone.highCutSlope = Slope_48;
+  telephone.peakFreq = 1500.f;
+  telephone.peakGainInDecibels = 6.f;
+  factory.emplace_back("Telephone", telephone);
+
+  return factory;
+}
+
+void designStages(const ChainSettings &settings, double sampleRate, PresetBank::Stages &stages)
+{
+  stages.sections[ChainPositions::LowCut] = designLowCutFilter<double>(settings, sampleRate);
+  stages.numSections[ChainPositions::LowCut] = getNumSections(settings.lowCutSlope);
+
+  stages.sections[ChainPositions::Peak][0] = designPeakFilter<double>(settings, sampleRate);
+  stages.numSections[ChainPositions::Peak] = 1;
+
+  stages.sections[ChainPositions::HighCut] = designHighCutFilter<double>(settings, sampleRate);
+  stages.numSections[ChainPositions::HighCut] = getNumSections(settings.highCutSlope);
+
+  for (size_t i = 0; i < numExtraBands; i++) {
+    stages.sections[getBandPosition(i)][0] = designBand<double>(settings.bands[i], sampleRate);
+    stages.numSections[getBandPosition(i)] = getNumSections(settings.bands[i]);
+  }
+}
+
+} // namespace
+
+PresetBank::PresetBank(juce::AudioProcessorValueTreeState &apvts)
+{
+  for (auto &[name, settings] : makeFactoryPrograms()) {
+    programs.push_back({name, quantizeChainSettings(apvts, settings)});
+  }
+}
+
+PresetBank::~PresetBank() = default;
+
+const juce::String &PresetBank::getName(int program) const
+{
+  return programs[static_cast<size_t>(program)].name;
+}
+
+const ChainSettings &PresetBank::getSettings(int program) const
+{
+  return programs[static_cast<size_t>(program)].settings;
+}
+
+void PresetBank::prepare(double sampleRate)
+{
+  stages.resize(programs.size() * numOversamplingFactors);
+
+  for (size_t program = 0; program < programs.size(); program++) {
+    for (int factor = 0; factor < numOversamplingFactors; factor++) {
+      designStages(programs[program].settings, sampleRate * (1 << factor),
+                   stages[program * numOversamplingFactors + static_cast<size_t>(factor)]);
+    }
+  }
+}
+
+const PresetBank::Stages &PresetBank::getStages(int program, int oversampling) const noexcept
+{
+  jassert(juce::isPositiveAndBelow(program, getNumPrograms()) && juce::isPositiveAndBelow(oversampling, numOversamplingFactors));
+  jassert(!stages.empty());
+  return stages[static_cast<size_t>(program) * numOversamplingFactors + static_cast<size_t>(oversampling)];
+}
+
+} // namespace audio_plugin
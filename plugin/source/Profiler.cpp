@@ -0,0 +1,192 @@
+#include "SimpleEQ/Profiler.h"
+
+#include <bit>
+
+namespace audio_plugin {
+
+DurationHistogram::Counts DurationHistogram::getSnapshot() const noexcept
+{
+  Counts snapshot;
+  for (size_t i = 0; i < numBuckets; i++) {
+    snapshot[i] = counts[i].load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+size_t DurationHistogram::getBucket(juce::uint64 nanoseconds) noexcept
+{
+  if (nanoseconds == 0) {
+    return 0;
+  }
+
+  // the octave is the position of the highest bit, the two bits below it pick the quarter of the octave
+  const auto octave = static_cast<size_t>(std::bit_width(nanoseconds)) - 1;
+  const auto quarter = octave >= 2 ? (nanoseconds >> (octave - 2)) & 3 : (nanoseconds << (2 - octave)) & 3;
+  return juce::jmin(numBuckets - 1, octave * bucketsPerOctave + static_cast<size_t>(quarter));
+}
+
+double DurationHistogram::getBucketStart(size_t bucket) noexcept
+{
+  const auto octave = static_cast<int>(bucket / bucketsPerOctave);
+  const auto quarter = static_cast<double>(bucket % bucketsPerOctave);
+  return std::ldexp(1.0 + quarter / static_cast<double>(bucketsPerOctave), octave);
+}
+
+DurationHistogram::Counts DurationHistogram::getDifference(const Counts &later, const Counts &earlier) noexcept
+{
+  Counts difference;
+  for (size_t i = 0; i < numBuckets; i++) {
+    difference[i] = later[i] - earlier[i];
+  }
+  return difference;
+}
+
+double DurationHistogram::getPercentile(const Counts &counts, double fraction) noexcept
+{
+  juce::uint64 total = 0;
+  for (auto count : counts) {
+    total += count;
+  }
+  if (total == 0) {
+    return 0.0;
+  }
+
+  const auto rank = juce::jmax<juce::uint64>(1, static_cast<juce::uint64>(std::ceil(fraction * static_cast<double>(total))));
+  juce::uint64 seen = 0;
+  for (size_t i = 0; i < numBuckets; i++) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return getBucketStart(i + 1);
+    }
+  }
+  return getBucketStart(numBuckets);
+}
+
+Profiler::Profiler() noexcept :
+nanosecondsPerTick(1.0e9 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()))
+{
+}
+
+void Profiler::finishBlock() noexcept
+{
+  auto &durations = current.durations;
+  durations[Block] = now() - current.start;
+
+  // coefficient updates only run inside the filters section, which timed them as well
+  durations[Filters] = juce::jmax<Ticks>(0, durations[Filters] - durations[Coefficients]);
+
+  // only what ran in the block is counted, e.g. an idle block doesn't pull the filter times down
+  for (size_t section = 0; section < numSections; section++) {
+    if (section == Block || durations[section] > 0) {
+      histograms[section].record(static_cast<juce::uint64>(ticksToNanoseconds(durations[section])));
+    }
+  }
+  numBlocks.fetch_add(1, std::memory_order_relaxed);
+
+  if (tracing.load(std::memory_order_acquire)) {
+    if (traceFifo.getFreeSpace() > 0) {
+      const auto write = traceFifo.write(1);
+      traceRecords[static_cast<size_t>(write.blockSize1 > 0 ? write.startIndex1 : write.startIndex2)] = current;
+    } else {
+      droppedTraceRecords.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+int Profiler::pullTrace(BlockRecord *destination, int maxRecords) noexcept
+{
+  const auto read = traceFifo.read(juce::jmin(maxRecords, traceFifo.getNumReady()));
+
+  for (int i = 0; i < read.blockSize1; i++) {
+    destination[i] = traceRecords[static_cast<size_t>(read.startIndex1 + i)];
+  }
+  for (int i = 0; i < read.blockSize2; i++) {
+    destination[read.blockSize1 + i] = traceRecords[static_cast<size_t>(read.startIndex2 + i)];
+  }
+
+  return read.blockSize1 + read.blockSize2;
+}
+
+ProfileTraceWriter::ProfileTraceWriter(Profiler &p, const juce::File &file) :
+juce::Thread("Profile Trace Writer"),
+profiler(p),
+origin(Profiler::now())
+{
+  file.deleteFile();
+  stream = std::make_unique<juce::FileOutputStream>(file);
+  if (stream->failedToOpen()) {
+    stream.reset();
+    return;
+  }
+
+  stream->writeText("[\n", false, false, nullptr);
+  writeEvent(R"({"name":"thread_name","ph":"M","pid":1,"tid":1,"args":{"name":"SimpleEQ processBlock"}})");
+
+  profiler.setTracing(true);
+  startThread(juce::Thread::Priority::low);
+}
+
+ProfileTraceWriter::~ProfileTraceWriter()
+{
+  if (stream == nullptr) {
+    return;
+  }
+
+  profiler.setTracing(false);
+  stopThread(1000);
+
+  // the thread is gone, this is the only consumer left
+  drain();
+  stream->writeText("\n]\n", false, false, nullptr);
+  stream->flush();
+}
+
+void ProfileTraceWriter::run()
+{
+  while (!threadShouldExit()) {
+    wait(drainIntervalMilliseconds);
+    drain();
+  }
+}
+
+void ProfileTraceWriter::drain()
+{
+  auto microseconds = [this](Profiler::Ticks ticks) { return juce::String(profiler.ticksToNanoseconds(ticks) / 1000.0, 3); };
+
+  for (auto numRecords = profiler.pullTrace(records.data(), static_cast<int>(records.size())); numRecords > 0;
+       numRecords = profiler.pullTrace(records.data(), static_cast<int>(records.size()))) {
+    for (size_t i = 0; i < static_cast<size_t>(numRecords); i++) {
+      const auto &record = records[i];
+      const auto timestamp = microseconds(record.start - origin);
+
+      juce::String block;
+      block << R"({"name":"processBlock","ph":"X","pid":1,"tid":1,"ts":)" << timestamp
+            << R"(,"dur":)" << microseconds(record.durations[Profiler::Block])
+            << R"(,"args":{"samples":)" << record.numSamples << "}}";
+      writeEvent(block);
+
+      // one counter track per section, in microseconds
+      juce::String sections;
+      sections << R"({"name":"Sections","ph":"C","pid":1,"tid":1,"ts":)" << timestamp << R"(,"args":{)";
+      for (size_t section = Profiler::Coefficients; section < Profiler::numSections; section++) {
+        sections << (section > Profiler::Coefficients ? "," : "") << "\"" << Profiler::sectionNames[section] << "\":"
+                 << microseconds(record.durations[section]);
+      }
+      sections << "}}";
+      writeEvent(sections);
+    }
+  }
+
+  stream->flush();
+}
+
+void ProfileTraceWriter::writeEvent(const juce::String &json)
+{
+  if (!firstEvent) {
+    stream->writeText(",\n", false, false, nullptr);
+  }
+  firstEvent = false;
+  stream->writeText(json, false, false, nullptr);
+}
+
+} // namespace audio_plugin
@@ -0,0 +1,127 @@
+#include "SimpleEQ/ResponseCurve.h"
+
+namespace audio_plugin {
+
+void ResponseCurve::prepare(int numPoints, double sampleRate)
+{
+  const auto size = static_cast<size_t>(juce::jmax(0, numPoints));
+  if (size == decibels.size() && sampleRate == currentSampleRate) {
+    return;
+  }
+
+  std::vector<double> frequencies(size);
+  for (size_t i = 0; i < size; i++) {
+    frequencies[i] = juce::mapToLog10<double>(static_cast<double>(i) / static_cast<double>(size), minFrequency, maxFrequency);
+  }
+
+  prepare(frequencies, sampleRate);
+}
+
+void ResponseCurve::prepare(const std::vector<double> &frequencies, double sampleRate)
+{
+  const auto size = frequencies.size();
+
+  currentSampleRate = sampleRate;
+  cos1.resize(size);
+  cos2.resize(size);
+  sin1.resize(size);
+  sin2.resize(size);
+  power.resize(size);
+  decibels.resize(size);
+
+  for (size_t i = 0; i < size; i++) {
+    const auto w = juce::MathConstants<double>::twoPi * frequencies[i] / sampleRate;
+
+    cos1[i] = std::cos(w);
+    cos2[i] = std::cos(2.0 * w);
+    sin1[i] = std::sin(w);
+    sin2[i] = std::sin(2.0 * w);
+  }
+
+  for (auto &stage : stages) {
+    evaluateStage(stage);
+  }
+}
+
+void ResponseCurve::setStage(size_t stage, const SectionCoefficients *sections, size_t numSections)
+{
+  auto &target = stages[stage];
+
+  // the vector never holds more than four sections, so it stops allocating after the first calls
+  target.sections.clear();
+  for (size_t i = 0; i < numSections; i++) {
+    const auto &raw = sections[i];
+    const auto a0Inv = 1.0 / static_cast<double>(raw[3]);
+
+    target.sections.push_back({raw[0] * a0Inv, raw[1] * a0Inv, raw[2] * a0Inv, raw[4] * a0Inv, raw[5] * a0Inv});
+  }
+
+  evaluateStage(target);
+}
+
+void ResponseCurve::evaluateStage(Stage &stage)
+{
+  const auto size = cos1.size();
+  stage.power.assign(size, 1.0);
+
+  auto *power = stage.power.data();
+  const auto *c1 = cos1.data();
+  const auto *c2 = cos2.data();
+  const auto *s1 = sin1.data();
+  const auto *s2 = sin2.data();
+
+  // |H(e^jw)|^2 = |b0 + b1 z^-1 + b2 z^-2|^2 / |1 + a1 z^-1 + a2 z^-2|^2, branch free so it vectorizes
+  for (const auto &section : stage.sections) {
+    for (size_t i = 0; i < size; i++) {
+      const auto numRe = section.b0 + section.b1 * c1[i] + section.b2 * c2[i];
+      const auto numIm = section.b1 * s1[i] + section.b2 * s2[i];
+      const auto denRe = 1.0 + section.a1 * c1[i] + section.a2 * c2[i];
+      const auto denIm = section.a1 * s1[i] + section.a2 * s2[i];
+
+      power[i] *= (numRe * numRe + numIm * numIm) / (denRe * denRe + denIm * denIm);
+    }
+  }
+
+  powerIsValid = false;
+  decibelsAreValid = false;
+}
+
+const std::vector<double> &ResponseCurve::getPower()
+{
+  if (powerIsValid) {
+    return power;
+  }
+
+  const auto size = static_cast<int>(power.size());
+  auto *result = power.data();
+
+  // most of the bands are usually switched off, their power is one everywhere
+  juce::FloatVectorOperations::fill(result, 1.0, size);
+  for (const auto &stage : stages) {
+    if (!stage.sections.empty()) {
+      juce::FloatVectorOperations::multiply(result, stage.power.data(), size);
+    }
+  }
+
+  powerIsValid = true;
+  return power;
+}
+
+const std::vector<double> &ResponseCurve::getMagnitudesInDecibels()
+{
+  if (decibelsAreValid) {
+    return decibels;
+  }
+
+  const auto &chainPower = getPower();
+
+  // the magnitudes are squared, hence 10 instead of 20 * log10
+  for (size_t i = 0; i < decibels.size(); i++) {
+    decibels[i] = 10.0 * std::log10(juce::jmax(chainPower[i], 1.0e-30));
+  }
+
+  decibelsAreValid = true;
+  return decibels;
+}
+
+} // namespace audio_plugin
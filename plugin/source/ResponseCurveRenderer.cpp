@@ -0,0 +1,145 @@
+#include "SimpleEQ/ResponseCurveRenderer.h"
+
+namespace audio_plugin {
+
+ResponseCurveRenderer::ResponseCurveRenderer(SimpleEQAudioProcessor &p) :
+juce::Thread("Response Curve Renderer"),
+processorRef(p)
+{
+}
+
+ResponseCurveRenderer::~ResponseCurveRenderer()
+{
+  signalThreadShouldExit();
+  notify();
+  stopThread(1000);
+}
+
+void ResponseCurveRenderer::start()
+{
+  startThread(juce::Thread::Priority::low);
+}
+
+void ResponseCurveRenderer::setSize(int newWidth, int newHeight)
+{
+  width.store(newWidth);
+  height.store(newHeight);
+  requestUpdate();
+}
+
+const juce::Image &ResponseCurveRenderer::acquireFrame() noexcept
+{
+  if (isFrameReady()) {
+    frontSlot = readySlot.exchange(frontSlot, std::memory_order_acq_rel) & slotMask;
+  }
+  return frames[static_cast<size_t>(frontSlot)];
+}
+
+void ResponseCurveRenderer::run()
+{
+  while (!threadShouldExit()) {
+    // notifications that arrive while a frame is rendered wake the next wait immediately
+    wait(-1);
+
+    if (threadShouldExit()) {
+      break;
+    }
+
+    // every request made before this point is covered by the frame rendered now
+    const auto request = requests.load(std::memory_order_acquire);
+    renderFrame();
+    completedRequests.store(request, std::memory_order_release);
+  }
+}
+
+void ResponseCurveRenderer::updateResponseCurve(int numPoints)
+{
+  auto chainSettings = processorRef.getChainSettingsSnapshot().read();
+
+  // with oversampling the curve shows the response of the filters at the oversampled rate
+  auto sampleRate = processorRef.getFilterSampleRate();
+  sampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+
+  // a new sample rate changes the coefficients of every stage
+  if (sampleRate != curveSampleRate) {
+    curveSampleRate = sampleRate;
+    settingsTracker.invalidate();
+  }
+  responseCurve.prepare(numPoints, sampleRate);
+
+  auto versions = settingsTracker.update(chainSettings);
+
+  if (versions.peak != appliedVersions.peak) {
+    auto peakCoefficients = designPeakFilter(chainSettings, sampleRate);
+    responseCurve.setStage(ChainPositions::Peak, &peakCoefficients, 1);
+  }
+  if (versions.lowCut != appliedVersions.lowCut) {
+    auto lowCutCoefficients = designLowCutFilter(chainSettings, sampleRate);
+    responseCurve.setStage(ChainPositions::LowCut, lowCutCoefficients.data(), getNumSections(chainSettings.lowCutSlope));
+  }
+  if (versions.highCut != appliedVersions.highCut) {
+    auto highCutCoefficients = designHighCutFilter(chainSettings, sampleRate);
+    responseCurve.setStage(ChainPositions::HighCut, highCutCoefficients.data(), getNumSections(chainSettings.highCutSlope));
+  }
+  for (size_t i = 0; i < numExtraBands; i++) {
+    if (versions.bands[i] != appliedVersions.bands[i]) {
+      auto bandCoefficients = designBand(chainSettings.bands[i], sampleRate);
+      responseCurve.setStage(getBandPosition(i), &bandCoefficients, getNumSections(chainSettings.bands[i]));
+    }
+  }
+
+  appliedVersions = versions;
+}
+
+void ResponseCurveRenderer::renderFrame()
+{
+  using namespace juce;
+
+  const auto w = width.load();
+  const auto h = height.load();
+  if (w <= 0 || h <= 0) {
+    return;
+  }
+
+  updateResponseCurve(w);
+
+  // the back slot belongs to this thread, it can be resized or cleared without synchronisation
+  auto &frame = frames[static_cast<size_t>(backSlot)];
+  if (!frame.isValid() || frame.getWidth() != w || frame.getHeight() != h) {
+    frame = Image(Image::ARGB, w, h, true, SoftwareImageType());
+  } else {
+    frame.clear(frame.getBounds());
+  }
+
+  const auto &mags = responseCurve.getMagnitudesInDecibels();
+
+  const double outputMin = h;
+  const double outputMax = 0.0;
+
+  // Map decibels to Screen coordinates
+  auto map = [outputMin, outputMax](double input) {
+    return static_cast<float>(jmap(input, -24.0, 24.0, outputMin, outputMax));
+  };
+
+  curvePath.clear();
+  curvePath.preallocateSpace(3 * static_cast<int>(mags.size()));
+
+  if (!mags.empty()) {
+    curvePath.startNewSubPath(0.f, map(mags.front()));
+
+    for (int i = 1; i < static_cast<int>(mags.size()); i++) {
+      curvePath.lineTo(static_cast<float>(i), map(mags[static_cast<size_t>(i)]));
+    }
+  }
+
+  {
+    Graphics g(frame);
+    g.setColour(Colours::white);
+    g.strokePath(curvePath, PathStrokeType(2.f));
+  }
+
+  // publish the frame and take over whichever slot was published before
+  backSlot = readySlot.exchange(backSlot | newFrameFlag, std::memory_order_acq_rel) & slotMask;
+}
+
+} // namespace audio_plugin
@@ -0,0 +1,143 @@
+#include "SimpleEQ/SpectrumAnalyzer.h"
+#include "SimpleEQ/ResponseCurve.h"
+
+#include <algorithm>
+
+namespace audio_plugin {
+
+SpectrumAnalyzer::SpectrumAnalyzer(AnalyzerFifo &analyzerFifo) : fifo(analyzerFifo)
+{
+  setFrameSize(defaultFftOrder, defaultOverlap);
+
+  // whatever was left from a previous consumer is stale
+  fifo.discard();
+  fifo.setEnabled(true);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+  fifo.setEnabled(false);
+}
+
+void SpectrumAnalyzer::setFrameSize(int fftOrder, int overlap)
+{
+  jassert(fftOrder > 0 && overlap > 0);
+
+  fftSize = 1 << fftOrder;
+  hopSize = juce::jmax(1, fftSize / overlap);
+  fft = std::make_unique<juce::dsp::FFT>(fftOrder);
+
+  window.assign(static_cast<size_t>(fftSize), 0.f);
+  juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), window.size(),
+                                                           juce::dsp::WindowingFunction<float>::hann, false);
+
+  // a full scale sine reads 0 dB regardless of the window and the frame size
+  auto windowSum = 0.f;
+  for (auto w : window) {
+    windowSum += w;
+  }
+  windowNormalisation = 2.f / windowSum;
+
+  fftData.assign(static_cast<size_t>(2 * fftSize), 0.f);
+  history.assign(static_cast<size_t>(fftSize), 0.f);
+  historyPosition = 0;
+  samplesUntilFrame = hopSize;
+  incoming.assign(static_cast<size_t>(AnalyzerFifo::capacity), 0.f);
+  binPower.assign(static_cast<size_t>(fftSize / 2 + 1), 0.f);
+
+  // the grid maps onto the new bins
+  if (currentSampleRate > 0.0) {
+    setGrid(static_cast<int>(decibels.size()), currentSampleRate);
+  }
+}
+
+void SpectrumAnalyzer::setGrid(int numPoints, double sampleRate)
+{
+  const auto size = static_cast<size_t>(juce::jmax(0, numPoints));
+  currentSampleRate = sampleRate;
+
+  gridBins.resize(size);
+  decibels.assign(size, minDecibels);
+  nextDecibels.assign(size, minDecibels);
+
+  for (size_t i = 0; i < size; i++) {
+    const auto frequency = juce::mapToLog10<double>(static_cast<double>(i) / static_cast<double>(size),
+                                                    ResponseCurve::minFrequency, ResponseCurve::maxFrequency);
+    gridBins[i] = static_cast<float>(frequency * fftSize / sampleRate);
+  }
+
+  updateDecibels();
+}
+
+bool SpectrumAnalyzer::update()
+{
+  auto numFrames = 0;
+
+  for (;;) {
+    const auto numRead = fifo.pull(incoming.data(), static_cast<int>(incoming.size()));
+    if (numRead == 0) {
+      break;
+    }
+
+    auto position = 0;
+
+    while (position < numRead) {
+      const auto count = juce::jmin(numRead - position, samplesUntilFrame, fftSize - historyPosition);
+
+      std::copy_n(incoming.data() + position, count, history.data() + historyPosition);
+      position += count;
+      historyPosition = (historyPosition + count) % fftSize;
+      samplesUntilFrame -= count;
+
+      if (samplesUntilFrame == 0) {
+        processFrame();
+        samplesUntilFrame = hopSize;
+        numFrames++;
+      }
+    }
+  }
+
+  return numFrames > 0 && updateDecibels();
+}
+
+void SpectrumAnalyzer::processFrame()
+{
+  // unroll the circular history, the oldest sample is at the write position
+  const auto tail = fftSize - historyPosition;
+  std::copy_n(history.data() + historyPosition, tail, fftData.data());
+  std::copy_n(history.data(), historyPosition, fftData.data() + tail);
+  std::fill(fftData.begin() + fftSize, fftData.end(), 0.f);
+
+  juce::FloatVectorOperations::multiply(fftData.data(), window.data(), fftSize);
+  fft->performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+  for (size_t bin = 0; bin < binPower.size(); bin++) {
+    const auto magnitude = fftData[bin] * windowNormalisation;
+    binPower[bin] += averagingWeight * (magnitude * magnitude - binPower[bin]);
+  }
+}
+
+bool SpectrumAnalyzer::updateDecibels()
+{
+  const auto lastBin = static_cast<float>(binPower.size() - 1);
+  auto changed = false;
+
+  for (size_t i = 0; i < gridBins.size(); i++) {
+    // interpolate between the two closest bins, the low end of the grid is much denser than the bins
+    const auto bin = juce::jlimit(0.f, lastBin, gridBins[i]);
+    const auto index = juce::jmin(static_cast<size_t>(bin), binPower.size() - 2);
+    const auto fraction = bin - static_cast<float>(index);
+    const auto power = binPower[index] + fraction * (binPower[index + 1] - binPower[index]);
+
+    nextDecibels[i] = juce::jmax(minDecibels, 10.f * std::log10(juce::jmax(power, 1.0e-12f)));
+    changed = changed || std::abs(nextDecibels[i] - decibels[i]) > changeThresholdDecibels;
+  }
+
+  // the comparison is against the spectrum last handed out, so slow drifts still add up to a change
+  if (changed) {
+    decibels.swap(nextDecibels);
+  }
+  return changed;
+}
+
+} // namespace audio_plugin
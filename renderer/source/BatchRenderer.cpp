@@ -0,0 +1,272 @@
+#include <SimpleEQ/PluginProcessor.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace audio_plugin_renderer {
+
+namespace {
+
+/**
+ * @brief Settings shared by all render jobs
+*/
+struct RenderSettings {
+  juce::MemoryBlock preset;
+  juce::File outputDirectory;
+  int blockSize {512};
+};
+
+/**
+ * @brief Outcome of rendering one file
+*/
+struct RenderResult {
+  bool succeeded {false};
+  juce::String message;
+  juce::int64 numSamples {0};
+  double seconds {0.0};
+};
+
+/**
+ * @brief Serialises console output of the worker threads
+*/
+std::mutex outputMutex;
+
+void print(const juce::String &text)
+{
+  std::scoped_lock lock(outputMutex);
+  std::cout << text << std::endl;
+}
+
+/**
+ * @brief Choose a bus layout with the channel count of the file
+*/
+juce::AudioChannelSet getChannelSet(int numChannels)
+{
+  auto channelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+  return channelSet.isDisabled() ? juce::AudioChannelSet::discreteChannels(numChannels) : channelSet;
+}
+
+/**
+ * @brief Render one file block by block, only a single block of audio is held in memory at a time
+*/
+RenderResult renderFile(const juce::File &input, const juce::File &outputFile, const RenderSettings &settings,
+                        juce::AudioFormatManager &formatManager)
+{
+  RenderResult result;
+
+  std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(input));
+  if (reader == nullptr) {
+    result.message = "unsupported or unreadable file";
+    return result;
+  }
+
+  const auto numChannels = static_cast<int>(reader->numChannels);
+  const auto sampleRate = reader->sampleRate;
+
+  audio_plugin::SimpleEQAudioProcessor processor;
+  processor.setStateInformation(settings.preset.getData(), static_cast<int>(settings.preset.getSize()));
+
+  juce::AudioProcessor::BusesLayout layout;
+  layout.inputBuses.add(getChannelSet(numChannels));
+  layout.outputBuses.add(getChannelSet(numChannels));
+  if (!processor.setBusesLayout(layout)) {
+    result.message = "channel layout not supported";
+    return result;
+  }
+
+  processor.setRateAndBufferSizeDetails(sampleRate, settings.blockSize);
+  processor.prepareToPlay(sampleRate, settings.blockSize);
+
+  auto *format = formatManager.findFormatForFileExtension(outputFile.getFileExtension());
+  outputFile.deleteFile();
+
+  auto stream = outputFile.createOutputStream();
+  if (format == nullptr || stream == nullptr) {
+    result.message = "cannot create " + outputFile.getFullPathName();
+    return result;
+  }
+
+  std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(),
+                                                                          sampleRate,
+                                                                          static_cast<unsigned int>(numChannels),
+                                                                          static_cast<int>(reader->bitsPerSample),
+                                                                          reader->metadataValues,
+                                                                          0));
+  if (writer == nullptr) {
+    result.message = "cannot write " + format->getFormatName();
+    return result;
+  }
+  // the writer owns the stream from now on
+  juce::ignoreUnused(stream.release());
+
+  juce::AudioBuffer<float> buffer(numChannels, settings.blockSize);
+  juce::MidiBuffer midi;
+
+  // the processor delays its output by the reported latency, drop the head and flush the tail instead
+  const auto latency = static_cast<juce::int64>(processor.getLatencySamples());
+  const auto totalSamples = reader->lengthInSamples + latency;
+
+  const auto startTicks = juce::Time::getHighResolutionTicks();
+
+  for (juce::int64 position = 0; position < totalSamples; position += settings.blockSize) {
+    const auto numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(settings.blockSize), totalSamples - position));
+    juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, numSamples);
+
+    // reading past the end of the file fills the block with silence
+    reader->read(&block, 0, numSamples, position, true, true);
+    processor.processBlock(block, midi);
+
+    const auto skip = static_cast<int>(juce::jlimit(static_cast<juce::int64>(0), static_cast<juce::int64>(numSamples), latency - position));
+    if (skip < numSamples && !writer->writeFromAudioSampleBuffer(block, skip, numSamples - skip)) {
+      result.message = "write error";
+      return result;
+    }
+  }
+
+  processor.releaseResources();
+
+  result.seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+  result.numSamples = reader->lengthInSamples;
+  result.succeeded = true;
+  return result;
+}
+
+/**
+ * @brief Thread pool job that renders a single file
+*/
+class RenderJob : public juce::ThreadPoolJob {
+public:
+  RenderJob(juce::File inputFile, juce::File outputFile, const RenderSettings &renderSettings) :
+  juce::ThreadPoolJob(inputFile.getFileName()),
+  input(std::move(inputFile)),
+  output(std::move(outputFile)),
+  settings(renderSettings)
+  { formatManager.registerBasicFormats(); }
+
+  JobStatus runJob() override
+  {
+    result = renderFile(input, output, settings, formatManager);
+
+    if (result.succeeded) {
+      const auto samplesPerSecond = result.seconds > 0.0 ? static_cast<double>(result.numSamples) / result.seconds : 0.0;
+      print(input.getFileName() + ": " + juce::String(result.numSamples) + " samples in "
+            + juce::String(result.seconds, 3) + " s, " + juce::String(samplesPerSecond, 0) + " samples/s");
+    } else {
+      print(input.getFileName() + ": failed, " + result.message);
+    }
+
+    return jobHasFinished;
+  }
+
+  const RenderResult &getResult() const { return result; }
+
+private:
+  juce::File input, output;
+  const RenderSettings &settings;
+  juce::AudioFormatManager formatManager;
+  RenderResult result;
+};
+
+void printUsage()
+{
+  std::cout << "Usage: SimpleEQBatchRenderer --preset <state file> --output <directory> "
+               "[--threads <count>] [--block-size <samples>] <input files...>" << std::endl
+            << "The preset is the binary state written by getStateInformation, "
+               "the inputs can be any format JUCE reads, e.g. WAV or AIFF." << std::endl
+            << "Every output gets the name of its input, so the inputs need distinct names "
+               "and can't be in the output directory." << std::endl;
+}
+
+int run(juce::ArgumentList args)
+{
+  if (args.containsOption("--help|-h") || !args.containsOption("--preset") || !args.containsOption("--output")) {
+    printUsage();
+    return 1;
+  }
+
+  RenderSettings settings;
+
+  auto presetFile = juce::File::getCurrentWorkingDirectory().getChildFile(args.removeValueForOption("--preset"));
+  if (!presetFile.loadFileAsData(settings.preset)) {
+    std::cerr << "Cannot read preset " << presetFile.getFullPathName() << std::endl;
+    return 1;
+  }
+
+  settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(args.removeValueForOption("--output"));
+  if (!settings.outputDirectory.createDirectory()) {
+    std::cerr << "Cannot create " << settings.outputDirectory.getFullPathName() << std::endl;
+    return 1;
+  }
+
+  auto numThreads = juce::SystemStats::getNumCpus();
+  if (args.containsOption("--threads")) {
+    numThreads = juce::jmax(1, args.removeValueForOption("--threads").getIntValue());
+  }
+  if (args.containsOption("--block-size")) {
+    settings.blockSize = juce::jmax(1, args.removeValueForOption("--block-size").getIntValue());
+  }
+
+  // every output is checked before anything is written: an input is never overwritten while its reader
+  // has it open, and two inputs with the same name don't render into the same file
+  std::vector<std::unique_ptr<RenderJob>> jobs;
+  juce::Array<juce::File> outputs;
+  for (const auto &argument : args.arguments) {
+    const auto input = argument.resolveAsFile();
+    const auto output = settings.outputDirectory.getChildFile(input.getFileName());
+
+    if (output == input) {
+      std::cerr << "Refusing to overwrite the input " << input.getFullPathName() << ", choose another output directory" << std::endl;
+      return 1;
+    }
+    if (outputs.contains(output)) {
+      std::cerr << "More than one input renders to " << output.getFullPathName() << std::endl;
+      return 1;
+    }
+
+    outputs.add(output);
+    jobs.push_back(std::make_unique<RenderJob>(input, output, settings));
+  }
+
+  if (jobs.empty()) {
+    printUsage();
+    return 1;
+  }
+
+  juce::ThreadPool pool(numThreads);
+  const auto startTicks = juce::Time::getHighResolutionTicks();
+
+  for (auto &job : jobs) {
+    pool.addJob(job.get(), false);
+  }
+
+  juce::int64 totalSamples = 0;
+  int numFailed = 0;
+
+  for (auto &job : jobs) {
+    pool.waitForJobToFinish(job.get(), -1);
+
+    totalSamples += job->getResult().numSamples;
+    numFailed += job->getResult().succeeded ? 0 : 1;
+  }
+
+  const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+  print("Rendered " + juce::String(static_cast<int>(jobs.size()) - numFailed) + " of " + juce::String(static_cast<int>(jobs.size()))
+        + " files on " + juce::String(numThreads) + " threads, "
+        + juce::String(seconds > 0.0 ? static_cast<double>(totalSamples) / seconds : 0.0, 0) + " samples/s in total");
+
+  return numFailed == 0 ? 0 : 1;
+}
+
+} // namespace
+
+} // namespace audio_plugin_renderer
+
+int main(int argc, char *argv[])
+{
+  // The processor's parameter state relies on the message manager being initialised
+  juce::ScopedJuceInitialiser_GUI juceInitialiser;
+  return audio_plugin_renderer::run(juce::ArgumentList(argc, argv));
+}
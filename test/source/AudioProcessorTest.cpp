@@ -1,10 +1,360 @@
 #include <SimpleEQ/PluginProcessor.h>
 #include <gtest/gtest.h>
 
+#include <set>
+
 namespace audio_plugin_test {
 
 TEST(AudioProcessor, Foo) {
   audio_plugin::SimpleEQAudioProcessor processor{};
 }
 
+TEST(AudioProcessor, ChainSettingsSnapshotFollowsParameters) {
+  audio_plugin::SimpleEQAudioProcessor processor{};
+  const auto &snapshot = processor.getChainSettingsSnapshot();
+
+  audio_plugin::ChainSettings settings;
+  auto version = audio_plugin::ChainSettingsSnapshot::noVersion;
+  ASSERT_TRUE(snapshot.readIfChanged(version, settings));
+  EXPECT_FALSE(snapshot.readIfChanged(version, settings));
+
+  auto *peakGain = processor.apvts.getParameter("Peak Gain");
+  auto *highCutSlope = processor.apvts.getParameter("HighCut Slope");
+  peakGain->setValueNotifyingHost(peakGain->convertTo0to1(6.f));
+  highCutSlope->setValueNotifyingHost(highCutSlope->convertTo0to1(3.f));
+
+  ASSERT_TRUE(snapshot.readIfChanged(version, settings));
+
+  const auto expected = audio_plugin::getChainSettings(processor.apvts);
+  EXPECT_EQ(settings.peakGainInDecibels, 6.f);
+  EXPECT_EQ(settings.highCutSlope, audio_plugin::Slope_48);
+  EXPECT_EQ(settings.peakGainInDecibels, expected.peakGainInDecibels);
+  EXPECT_EQ(settings.peakFreq, expected.peakFreq);
+  EXPECT_EQ(settings.peakQuality, expected.peakQuality);
+  EXPECT_EQ(settings.lowCutFreq, expected.lowCutFreq);
+  EXPECT_EQ(settings.highCutFreq, expected.highCutFreq);
+  EXPECT_EQ(settings.lowCutSlope, expected.lowCutSlope);
+  EXPECT_EQ(settings.highCutSlope, expected.highCutSlope);
+}
+
+TEST(AudioProcessor, ReportsOversamplingLatency) {
+  audio_plugin::SimpleEQAudioProcessor processor{};
+  processor.setRateAndBufferSizeDetails(48000.0, 512);
+  processor.prepareToPlay(48000.0, 512);
+  EXPECT_EQ(processor.getLatencySamples(), 0);
+
+  auto *oversampling = processor.apvts.getParameter("Oversampling");
+  oversampling->setValueNotifyingHost(oversampling->convertTo0to1(1.f));
+  const auto latency2x = processor.getLatencySamples();
+  EXPECT_GT(latency2x, 0);
+
+  oversampling->setValueNotifyingHost(oversampling->convertTo0to1(2.f));
+  EXPECT_GT(processor.getLatencySamples(), latency2x);
+  EXPECT_EQ(processor.getFilterSampleRate(), 4 * 48000.0);
+
+  // preparing again keeps the latency of the selected factor
+  processor.prepareToPlay(48000.0, 512);
+  EXPECT_GT(processor.getLatencySamples(), latency2x);
+}
+
+TEST(AudioProcessor, ReportsLinearPhaseLatency) {
+  audio_plugin::SimpleEQAudioProcessor processor{};
+  processor.setRateAndBufferSizeDetails(48000.0, 512);
+  processor.prepareToPlay(48000.0, 512);
+
+  // 0.1 s at 48 kHz rounds up to a kernel of 8192 taps, centred on tap 4096
+  processor.apvts.getParameter("Linear Phase")->setValueNotifyingHost(1.f);
+  EXPECT_EQ(processor.getLatencySamples(), 4096);
+
+  processor.apvts.getParameter("Linear Phase")->setValueNotifyingHost(0.f);
+  EXPECT_EQ(processor.getLatencySamples(), 0);
+}
+
+TEST(AudioProcessor, FiltersTheFirstLinearPhaseBlockAfterPreparing) {
+  constexpr int blockSize = 512;
+
+  audio_plugin::SimpleEQAudioProcessor processor{};
+  processor.apvts.getParameter("Linear Phase")->setValueNotifyingHost(1.f);
+  processor.setNonRealtime(true);
+  processor.setRateAndBufferSizeDetails(48000.0, blockSize);
+  processor.prepareToPlay(48000.0, blockSize);
+
+  // rendered straight away, like an offline render: nothing passes before the latency is over
+  const auto latency = processor.getLatencySamples();
+  juce::AudioBuffer<float> output(2, latency + blockSize);
+  juce::AudioBuffer<float> buffer(2, blockSize);
+  juce::MidiBuffer midi;
+
+  for (int start = 0; start < output.getNumSamples(); start += blockSize) {
+    buffer.clear();
+    if (start == 0) {
+      buffer.setSample(0, 0, 1.f);
+      buffer.setSample(1, 0, 1.f);
+    }
+    processor.processBlock(buffer, midi);
+    for (int channel = 0; channel < 2; channel++) {
+      output.copyFrom(channel, start, buffer, channel, 0, blockSize);
+    }
+  }
+
+  // an unfiltered first block would pass the impulse at sample 0, the kernel puts it at its centre
+  EXPECT_LT(output.getMagnitude(0, blockSize), 0.01f);
+  EXPECT_GT(output.getSample(0, latency), 0.5f);
+  EXPECT_GT(output.getSample(1, latency), 0.5f);
+}
+
+TEST(AudioProcessor, ReportsTailLengthFromSlopesAndQuality) {
+  audio_plugin::SimpleEQAudioProcessor processor{};
+  processor.setRateAndBufferSizeDetails(48000.0, 512);
+  processor.prepareToPlay(48000.0, 512);
+
+  auto set = [&processor](const juce::String &parameterID, float value) {
+    auto *parameter = processor.apvts.getParameter(parameterID);
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+  };
+
+  set("LowCut Freq", 100.f);
+  const auto gentle = processor.getTailLengthSeconds();
+  EXPECT_GT(gentle, 0.0);
+
+  set("LowCut Slope", 3.f);
+  const auto steep = processor.getTailLengthSeconds();
+  EXPECT_GT(steep, gentle);
+
+  set("Peak Gain", 12.f);
+  set("Peak Quality", 1.f);
+  const auto wide = processor.getTailLengthSeconds();
+  set("Peak Quality", 10.f);
+  EXPECT_GT(processor.getTailLengthSeconds(), wide);
+}
+
+TEST(AudioProcessor, StopsProcessingOnceTheTailDecayed) {
+  constexpr double sampleRate = 48000.0;
+  constexpr int blockSize = 256;
+
+  audio_plugin::SimpleEQAudioProcessor processor{};
+  processor.apvts.getParameter("Peak Gain")->setValueNotifyingHost(1.f);
+  processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+  processor.prepareToPlay(sampleRate, blockSize);
+
+  juce::AudioBuffer<float> buffer(2, blockSize);
+  juce::MidiBuffer midi;
+
+  buffer.clear();
+  buffer.setSample(0, 0, 1.f);
+  buffer.setSample(1, 0, 1.f);
+  processor.processBlock(buffer, midi);
+
+  // the impulse rings on while the input is silent, until the reported tail is over
+  const auto tailBlocks = static_cast<int>(std::ceil(processor.getTailLengthSeconds() * sampleRate / blockSize));
+  auto ringing = false;
+  for (int i = 0; i < tailBlocks + 2; i++) {
+    buffer.clear();
+    processor.processBlock(buffer, midi);
+    ringing = ringing || buffer.getMagnitude(0, 0, blockSize) > 0.f;
+  }
+  EXPECT_TRUE(ringing);
+
+  // past the tail, silence passes straight through
+  buffer.clear();
+  processor.processBlock(buffer, midi);
+  EXPECT_EQ(buffer.getMagnitude(0, 0, blockSize), 0.f);
+  EXPECT_EQ(buffer.getMagnitude(1, 0, blockSize), 0.f);
+}
+
+TEST(AudioProcessor, ProcessesDoubleBuffersLikeFloatBuffers) {
+  constexpr double sampleRate = 48000.0;
+  constexpr int blockSize = 256;
+
+  audio_plugin::SimpleEQAudioProcessor singleProcessor{}, doubleProcessor{};
+  EXPECT_TRUE(doubleProcessor.supportsDoublePrecisionProcessing());
+  doubleProcessor.setProcessingPrecision(juce::AudioProcessor::doublePrecision);
+
+  juce::AudioBuffer<float> singleBuffer(2, blockSize);
+  juce::AudioBuffer<double> doubleBuffer(2, blockSize);
+  juce::MidiBuffer midi;
+
+  for (auto *processor : {&singleProcessor, &doubleProcessor}) {
+    processor->apvts.getParameter("Peak Gain")->setValueNotifyingHost(1.f);
+    processor->apvts.getParameter("LowCut Slope")->setValueNotifyingHost(1.f);
+    processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor->prepareToPlay(sampleRate, blockSize);
+  }
+
+  juce::Random random {1};
+  for (int block = 0; block < 8; block++) {
+    for (int ch = 0; ch < 2; ch++) {
+      for (int i = 0; i < blockSize; i++) {
+        const auto sample = random.nextFloat() * 2.f - 1.f;
+        singleBuffer.setSample(ch, i, sample);
+        doubleBuffer.setSample(ch, i, sample);
+      }
+    }
+
+    singleProcessor.processBlock(singleBuffer, midi);
+    doubleProcessor.processBlock(doubleBuffer, midi);
+
+    for (int ch = 0; ch < 2; ch++) {
+      for (int i = 0; i < blockSize; i++) {
+        ASSERT_NEAR(singleBuffer.getSample(ch, i), doubleBuffer.getSample(ch, i), 1.0e-4);
+      }
+    }
+  }
+}
+
+TEST(AudioProcessor, RestoresBinaryAndValueTreeState) {
+  audio_plugin::SimpleEQAudioProcessor source{};
+  source.apvts.getParameter("Peak Gain")->setValueNotifyingHost(0.75f);
+  source.apvts.getParameter("Band 5 Type")->setValueNotifyingHost(1.f);
+  source.apvts.getParameter("Oversampling")->setValueNotifyingHost(1.f);
+
+  juce::MemoryBlock binary;
+  source.getStateInformation(binary);
+
+  juce::MemoryBlock tree;
+  {
+    juce::MemoryOutputStream stream(tree, false);
+    source.apvts.state.writeToStream(stream);
+  }
+  EXPECT_LT(binary.getSize(), tree.getSize());
+
+  for (const auto *state : {&binary, &tree}) {
+    audio_plugin::SimpleEQAudioProcessor restored{};
+    restored.setStateInformation(state->getData(), static_cast<int>(state->getSize()));
+
+    const auto &expected = source.getParameters();
+    const auto &actual = restored.getParameters();
+    ASSERT_EQ(expected.size(), actual.size());
+    for (int i = 0; i < expected.size(); i++) {
+      EXPECT_NEAR(expected[i]->getValue(), actual[i]->getValue(), 1.0e-6f) << expected[i]->getName(64);
+    }
+  }
+}
+
+TEST(AudioProcessor, MatchesBinaryStateByParameterID) {
+  using Processor = audio_plugin::SimpleEQAudioProcessor;
+
+  // written by a layout with the parameters in another order, one of them since removed
+  juce::MemoryBlock state;
+  {
+    juce::MemoryOutputStream stream(state, false);
+    stream.writeInt(Processor::stateMagic);
+    stream.writeInt(Processor::stateVersion);
+    stream.writeInt(0);
+    stream.writeInt(3);
+    stream.writeInt(static_cast<int>(Processor::getStateKey("Smoothing")));
+    stream.writeFloat(1.f);
+    stream.writeInt(static_cast<int>(Processor::getStateKey("Removed Parameter")));
+    stream.writeFloat(0.5f);
+    stream.writeInt(static_cast<int>(Processor::getStateKey("Peak Gain")));
+    stream.writeFloat(0.25f);
+  }
+
+  Processor processor{};
+  const auto defaultLowCut = processor.apvts.getParameter("LowCut Freq")->getValue();
+  processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+  EXPECT_EQ(processor.apvts.getParameter("Smoothing")->getValue(), 1.f);
+  EXPECT_EQ(processor.apvts.getParameter("Peak Gain")->getValue(), 0.25f);
+  EXPECT_EQ(processor.apvts.getParameter("LowCut Freq")->getValue(), defaultLowCut);
+
+  // every parameter needs a key of its own
+  std::set<juce::uint32> keys;
+  for (auto *parameter : processor.getParameters()) {
+    keys.insert(Processor::getStateKey(dynamic_cast<juce::AudioProcessorParameterWithID *>(parameter)->paramID));
+  }
+  EXPECT_EQ(static_cast<int>(keys.size()), processor.getParameters().size());
+}
+
+TEST(AudioProcessor, SwitchesToProgramsAndTheirSettings) {
+  constexpr double sampleRate = 48000.0;
+  constexpr int blockSize = 256;
+
+  audio_plugin::SimpleEQAudioProcessor processor{};
+  processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+  processor.prepareToPlay(sampleRate, blockSize);
+  ASSERT_GT(processor.getNumPrograms(), 1);
+
+  for (int program = 0; program < processor.getNumPrograms(); program++) {
+    processor.setCurrentProgram(program);
+    EXPECT_EQ(processor.getCurrentProgram(), program);
+    EXPECT_FALSE(processor.getProgramName(program).isEmpty());
+
+    // the parameters now hold the program exactly, so the snapshot matches the precomputed settings
+    const auto &expected = processor.getPresetBank().getSettings(program);
+    const auto settings = audio_plugin::getChainSettings(processor.apvts);
+    EXPECT_EQ(settings.lowCutFreq, expected.lowCutFreq);
+    EXPECT_EQ(settings.lowCutSlope, expected.lowCutSlope);
+    EXPECT_EQ(settings.peakGainInDecibels, expected.peakGainInDecibels);
+    EXPECT_EQ(settings.peakQuality, expected.peakQuality);
+    EXPECT_EQ(settings.bands[0].type, expected.bands[0].type);
+  }
+}
+
+TEST(AudioProcessor, CrossfadesIntoTheProgramLikeItsParameters) {
+  using Processor = audio_plugin::SimpleEQAudioProcessor;
+  constexpr double sampleRate = 48000.0;
+  constexpr int blockSize = 256;
+  constexpr int program = 1;
+
+  auto prepare = [](Processor &processor) {
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+  };
+
+  juce::Random random {1};
+  juce::AudioBuffer<float> input(2, blockSize);
+  auto fillInput = [&random, &input] {
+    for (int ch = 0; ch < 2; ch++) {
+      for (int i = 0; i < blockSize; i++) {
+        input.setSample(ch, i, (random.nextFloat() * 2.f - 1.f) * 0.25f);
+      }
+    }
+  };
+
+  juce::MidiBuffer midi;
+  auto process = [&input, &midi](Processor &processor, juce::AudioBuffer<float> &output) {
+    output.makeCopyOf(input, true);
+    processor.processBlock(output, midi);
+  };
+
+  // one instance switches, the other stays on the outgoing settings and shows what the fade starts from
+  Processor switching{}, staying{};
+  prepare(switching);
+  prepare(staying);
+
+  juce::AudioBuffer<float> output(2, blockSize), outgoing(2, blockSize), incoming(2, blockSize);
+  for (int block = 0; block < 8; block++) {
+    fillInput();
+    process(switching, output);
+    process(staying, outgoing);
+  }
+
+  switching.setCurrentProgram(program);
+
+  // the incoming program as if it had been loaded through its parameters, starting with the switch
+  Processor loaded{};
+  audio_plugin::setChainSettings(loaded.apvts, switching.getPresetBank().getSettings(program));
+  prepare(loaded);
+
+  // a linear fade from the outgoing chain, which is continuous with the blocks before the switch, to a
+  // chain that matches the parameters of the program once the fade is over
+  const auto fadeLength = juce::roundToInt(Processor::programFadeSeconds * sampleRate);
+  for (int start = 0; start < fadeLength + 4 * blockSize; start += blockSize) {
+    fillInput();
+    process(switching, output);
+    process(staying, outgoing);
+    process(loaded, incoming);
+
+    for (int ch = 0; ch < 2; ch++) {
+      for (int i = 0; i < blockSize; i++) {
+        const auto gain = juce::jmin(1.f, static_cast<float>(start + i + 1) / static_cast<float>(fadeLength));
+        const auto from = outgoing.getSample(ch, i);
+        const auto expected = from + (incoming.getSample(ch, i) - from) * gain;
+        ASSERT_NEAR(output.getSample(ch, i), expected, 1.0e-4f) << "sample " << start + i << " of channel " << ch;
+      }
+    }
+  }
+}
+
 } // namespace audio_plugin_test
@@ -0,0 +1,75 @@
+#include <SimpleEQ/PluginProcessor.h>
+#include <gtest/gtest.h>
+
+namespace audio_plugin_test {
+
+using namespace audio_plugin;
+
+TEST(CoefficientCache, ReturnsWhatWasInserted) {
+  auto cache = std::make_unique<CoefficientCache>();
+  const CoefficientCache::Key key {1, 3, 80.f, 0.f, 0.f, 48000.0};
+
+  CoefficientCache::Sections sections {};
+  EXPECT_FALSE(cache->lookup(key, sections));
+
+  CoefficientCache::Sections designed {};
+  designed[0] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+  designed[3] = {-1.0, -2.0, -3.0, -4.0, -5.0, -6.0};
+  cache->insert(key, designed);
+
+  ASSERT_TRUE(cache->lookup(key, sections));
+  EXPECT_EQ(sections, designed);
+
+  // any difference in the key is a different design
+  auto otherRate = key;
+  otherRate.sampleRate = 96000.0;
+  EXPECT_FALSE(cache->lookup(otherRate, sections));
+
+  const auto statistics = cache->getStatistics();
+  EXPECT_EQ(statistics.hits, 1u);
+  EXPECT_EQ(statistics.misses, 2u);
+  EXPECT_EQ(statistics.insertions, 1u);
+}
+
+TEST(CoefficientCache, EvictsTheLeastRecentlyUsedEntries) {
+  auto cache = std::make_unique<CoefficientCache>();
+  constexpr auto capacity = CoefficientCache::numBuckets * CoefficientCache::numWays;
+
+  CoefficientCache::Sections sections {};
+  const CoefficientCache::Key kept {2, 0, 1000.f, 1.f, 6.f, 48000.0};
+  cache->insert(kept, sections);
+
+  // many more keys than the cache holds, the first one stays the most recently used of its bucket
+  for (size_t i = 0; i < 4 * capacity; i++) {
+    cache->insert({1, 0, 20.f + static_cast<float>(i), 0.f, 0.f, 48000.0}, sections);
+    ASSERT_TRUE(cache->lookup(kept, sections));
+  }
+
+  EXPECT_GT(cache->getStatistics().evictions, 0u);
+  EXPECT_TRUE(cache->lookup(kept, sections));
+}
+
+TEST(CoefficientCache, IsSharedBetweenInstances) {
+  constexpr double sampleRate = 48000.0;
+  constexpr int blockSize = 64;
+
+  auto prepare = [&](SimpleEQAudioProcessor &processor) {
+    processor.apvts.getParameter("LowCut Freq")->setValueNotifyingHost(0.2f);
+    processor.apvts.getParameter("LowCut Slope")->setValueNotifyingHost(1.f);
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+  };
+
+  SimpleEQAudioProcessor first{};
+  prepare(first);
+
+  // the second instance finds every stage the first one designed
+  const auto before = first.getCoefficientCacheStatistics();
+  SimpleEQAudioProcessor second{};
+  prepare(second);
+  const auto after = second.getCoefficientCacheStatistics();
+
+  EXPECT_GE(after.hits - before.hits, 3u);
+}
+
+} // namespace audio_plugin_test
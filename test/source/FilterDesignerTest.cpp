@@ -0,0 +1,99 @@
+#include <SimpleEQ/Biquad.h>
+#include <SimpleEQ/FilterDesigner.h>
+#include <gtest/gtest.h>
+
+#include "RealtimeSafety.h"
+
+namespace audio_plugin_test {
+
+using namespace audio_plugin;
+
+namespace {
+
+/**
+ * @brief Compare a raw design with the normalised {b0, b1, b2, a1, a2} JUCE stores in its Coefficients
+*/
+void expectSameSection(const std::array<double, 6> &raw, const juce::dsp::IIR::Coefficients<double> &reference)
+{
+  const auto c = BiquadCoefficients<double>::fromRaw(raw);
+  const auto *expected = reference.coefficients.begin();
+
+  EXPECT_NEAR(c.b0, expected[0], 1.0e-9);
+  EXPECT_NEAR(c.b1, expected[1], 1.0e-9);
+  EXPECT_NEAR(c.b2, expected[2], 1.0e-9);
+  EXPECT_NEAR(c.a1, expected[3], 1.0e-9);
+  EXPECT_NEAR(c.a2, expected[4], 1.0e-9);
+}
+
+} // namespace
+
+TEST(FilterDesigner, DampingTableMatchesPoleAngles) {
+  for (int order = 2; order <= filter_design::maxButterworthOrder; order += 2) {
+    const auto &dampings = filter_design::butterworthDampings[filter_design::getNumButterworthSections(order) - 1];
+    for (size_t i = 0; i < filter_design::getNumButterworthSections(order); i++) {
+      const auto angle = (2.0 * static_cast<double>(i) + 1.0) * juce::MathConstants<double>::pi / (2.0 * order);
+      EXPECT_NEAR(dampings[i], 2.0 * std::cos(angle), 1.0e-15);
+    }
+  }
+}
+
+TEST(FilterDesigner, MatchesJuceButterworthCascades) {
+  using FilterDesign = juce::dsp::FilterDesign<double>;
+
+  for (auto sampleRate : {44100.0, 96000.0, 192000.0}) {
+    for (auto frequency : {20.0, 1000.0, 18000.0}) {
+      for (int order = 2; order <= filter_design::maxButterworthOrder; order += 2) {
+        std::array<std::array<double, 6>, 4> highPass {}, lowPass {};
+        filter_design::designButterworthHighPass(highPass, order, sampleRate, frequency);
+        filter_design::designButterworthLowPass(lowPass, order, sampleRate, frequency);
+
+        const auto highReference = FilterDesign::designIIRHighpassHighOrderButterworthMethod(frequency, sampleRate, order);
+        const auto lowReference = FilterDesign::designIIRLowpassHighOrderButterworthMethod(frequency, sampleRate, order);
+        ASSERT_EQ(static_cast<size_t>(highReference.size()), filter_design::getNumButterworthSections(order));
+
+        for (int i = 0; i < highReference.size(); i++) {
+          expectSameSection(highPass[static_cast<size_t>(i)], *highReference[i]);
+          expectSameSection(lowPass[static_cast<size_t>(i)], *lowReference[i]);
+        }
+      }
+    }
+  }
+}
+
+TEST(FilterDesigner, MatchesJucePeakAndPasses) {
+  using ArrayCoefficients = juce::dsp::IIR::ArrayCoefficients<double>;
+  constexpr double sampleRate = 48000.0;
+
+  for (auto frequency : {20.0, 1000.0, 18000.0}) {
+    for (auto quality : {0.1, 0.707, 10.0}) {
+      const auto peak = filter_design::designPeak<double>(sampleRate, frequency, quality, 4.0);
+      const auto peakReference = ArrayCoefficients::makePeakFilter(sampleRate, frequency, quality, 4.0);
+      expectSameSection(peak, juce::dsp::IIR::Coefficients<double>(peakReference));
+
+      const auto highPass = filter_design::designHighPass<double>(sampleRate, frequency, quality);
+      expectSameSection(highPass, juce::dsp::IIR::Coefficients<double>(ArrayCoefficients::makeHighPass(sampleRate, frequency, quality)));
+
+      const auto lowPass = filter_design::designLowPass<double>(sampleRate, frequency, quality);
+      expectSameSection(lowPass, juce::dsp::IIR::Coefficients<double>(ArrayCoefficients::makeLowPass(sampleRate, frequency, quality)));
+    }
+  }
+
+  // a peak at unity gain stays exactly flat, which lets the chain skip it
+  EXPECT_TRUE(BiquadCoefficients<float>::fromRaw(filter_design::designPeak<float>(sampleRate, 1000.0, 1.0, 1.0)).isIdentity());
+}
+
+TEST(FilterDesigner, DoesNotAllocate) {
+  std::array<std::array<float, 6>, 4> sections {};
+  RealtimeViolations violations;
+  {
+    ScopedRealtimeSection section;
+    filter_design::designButterworthHighPass(sections, 8, 48000.0, 20.0);
+    filter_design::designButterworthLowPass(sections, 8, 48000.0, 20000.0);
+    sections[0] = filter_design::designPeak<float>(48000.0, 1000.0, 1.0, 2.0);
+    violations = section.getViolations();
+  }
+
+  EXPECT_FALSE(violations.any());
+}
+
+} // namespace audio_plugin_test
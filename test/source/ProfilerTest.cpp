@@ -0,0 +1,110 @@
+#include <SimpleEQ/PluginProcessor.h>
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+namespace audio_plugin_test {
+
+using namespace audio_plugin;
+
+TEST(Profiler, HistogramPercentilesFallIntoTheRightBuckets) {
+  DurationHistogram histogram;
+  const auto before = histogram.getSnapshot();
+
+  for (int i = 0; i < 98; i++) {
+    histogram.record(1000);
+  }
+  histogram.record(50000);
+  histogram.record(2000000);
+
+  const auto counts = DurationHistogram::getDifference(histogram.getSnapshot(), before);
+
+  // the percentiles are the upper edges of their buckets, a quarter octave at most above the durations
+  const auto p50 = DurationHistogram::getPercentile(counts, 0.5);
+  EXPECT_GT(p50, 1000.0);
+  EXPECT_LE(p50, 1000.0 * 1.25);
+
+  const auto p99 = DurationHistogram::getPercentile(counts, 0.99);
+  EXPECT_GT(p99, 50000.0);
+  EXPECT_LE(p99, 50000.0 * 1.25);
+
+  EXPECT_GT(DurationHistogram::getPercentile(counts, 1.0), 2000000.0);
+  EXPECT_EQ(DurationHistogram::getPercentile(before, 0.5), 0.0);
+}
+
+TEST(Profiler, ProcessorRecordsEveryBlock) {
+  if constexpr (!Profiler::isEnabled) {
+    GTEST_SKIP() << "built without SIMPLEEQ_PROFILING";
+  }
+
+  constexpr double sampleRate = 48000.0;
+  constexpr int blockSize = 256;
+  constexpr int numBlocks = 16;
+
+  SimpleEQAudioProcessor processor{};
+  processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+  processor.prepareToPlay(sampleRate, blockSize);
+
+  const auto &profiler = processor.getProfiler();
+  std::array<DurationHistogram::Counts, Profiler::numSections> before;
+  for (size_t section = 0; section < Profiler::numSections; section++) {
+    before[section] = profiler.getHistogram(static_cast<Profiler::Section>(section)).getSnapshot();
+  }
+  const auto blocksBefore = profiler.getNumBlocks();
+
+  juce::AudioBuffer<float> buffer(2, blockSize);
+  juce::MidiBuffer midi;
+  juce::Random random {3};
+
+  for (int block = 0; block < numBlocks; block++) {
+    for (int ch = 0; ch < 2; ch++) {
+      for (int i = 0; i < blockSize; i++) {
+        buffer.setSample(ch, i, random.nextFloat() * 2.f - 1.f);
+      }
+    }
+    processor.processBlock(buffer, midi);
+  }
+
+  auto count = [&](Profiler::Section section) {
+    const auto counts = DurationHistogram::getDifference(profiler.getHistogram(section).getSnapshot(), before[section]);
+    return std::accumulate(counts.begin(), counts.end(), juce::uint64 {0});
+  };
+
+  EXPECT_EQ(profiler.getNumBlocks() - blocksBefore, static_cast<juce::uint64>(numBlocks));
+  EXPECT_EQ(count(Profiler::Block), static_cast<juce::uint64>(numBlocks));
+  EXPECT_EQ(count(Profiler::Filters), static_cast<juce::uint64>(numBlocks));
+}
+
+TEST(Profiler, TraceIsValidJson) {
+  if constexpr (!Profiler::isEnabled) {
+    GTEST_SKIP() << "built without SIMPLEEQ_PROFILING";
+  }
+
+  constexpr int numBlocks = 5;
+  const auto file = juce::File::createTempFile(".json");
+
+  {
+    auto profiler = std::make_unique<Profiler>();
+    ProfileTraceWriter writer {*profiler, file};
+    ASSERT_TRUE(writer.isWriting());
+
+    for (int block = 0; block < numBlocks; block++) {
+      profiler->beginBlock(64);
+      profiler->add(Profiler::Filters, 100);
+      profiler->endBlock();
+    }
+  }
+
+  const auto trace = juce::JSON::parse(file);
+  file.deleteFile();
+
+  // the thread name, then a complete event and a counter sample per block
+  ASSERT_TRUE(trace.isArray());
+  ASSERT_EQ(trace.size(), 1 + 2 * numBlocks);
+  EXPECT_EQ(trace[1]["ph"].toString(), "X");
+  EXPECT_EQ(static_cast<int>(trace[1]["args"]["samples"]), 64);
+  EXPECT_EQ(trace[2]["ph"].toString(), "C");
+  EXPECT_TRUE(trace[2]["args"].hasProperty("Filters"));
+}
+
+} // namespace audio_plugin_test
@@ -0,0 +1,268 @@
+#include "RealtimeSafety.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+
+namespace audio_plugin_test {
+
+namespace {
+
+// Plain thread locals of the executable live in static TLS, so the hooks can touch them without allocating
+thread_local bool realtimeSectionActive = false;
+thread_local int allocationCount = 0;
+thread_local int deallocationCount = 0;
+thread_local int lockCount = 0;
+
+inline void recordAllocation() noexcept
+{
+  if (realtimeSectionActive) {
+    ++allocationCount;
+  }
+}
+
+inline void recordDeallocation(const void *pointer) noexcept
+{
+  if (realtimeSectionActive && pointer != nullptr) {
+    ++deallocationCount;
+  }
+}
+
+inline void recordLock() noexcept
+{
+  if (realtimeSectionActive) {
+    ++lockCount;
+  }
+}
+
+void resolveInterposedFunctions() noexcept;
+
+} // namespace
+
+ScopedRealtimeSection::ScopedRealtimeSection() : wasActive(realtimeSectionActive)
+{
+  // resolving may allocate, which must neither happen inside the section nor be counted
+  resolveInterposedFunctions();
+
+  allocationCount = 0;
+  deallocationCount = 0;
+  lockCount = 0;
+  realtimeSectionActive = true;
+}
+
+ScopedRealtimeSection::~ScopedRealtimeSection()
+{
+  realtimeSectionActive = wasActive;
+}
+
+RealtimeViolations ScopedRealtimeSection::getViolations() const
+{
+  return {allocationCount, deallocationCount, lockCount};
+}
+
+#if defined(__GLIBC__)
+
+bool canDetectLocks()
+{
+  return true;
+}
+
+namespace {
+
+/**
+ * @brief Look up the next definition of an interposed function, unless it was resolved already
+ * The lock functions have no public alias, dlsym resolves them without taking any of them.
+*/
+template <typename Function>
+Function findNext(std::atomic<Function> &cache, const char *name) noexcept
+{
+  auto function = cache.load(std::memory_order_acquire);
+  if (function == nullptr) {
+    function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+    cache.store(function, std::memory_order_release);
+  }
+  return function;
+}
+
+using MutexLock = int (*)(pthread_mutex_t *);
+using ReadWriteLock = int (*)(pthread_rwlock_t *);
+
+std::atomic<MutexLock> nextMutexLock {nullptr};
+std::atomic<ReadWriteLock> nextReadLock {nullptr};
+std::atomic<ReadWriteLock> nextWriteLock {nullptr};
+
+void resolveInterposedFunctions() noexcept
+{
+  findNext(nextMutexLock, "pthread_mutex_lock");
+  findNext(nextReadLock, "pthread_rwlock_rdlock");
+  findNext(nextWriteLock, "pthread_rwlock_wrlock");
+}
+
+// resolved during static initialisation already, locks taken before that still resolve on first use
+[[maybe_unused]] const bool interposedFunctionsResolved = (resolveInterposedFunctions(), true);
+
+} // namespace
+
+} // namespace audio_plugin_test
+
+// With glibc every allocation, including the ones of operator new, ends up in these functions,
+// so interposing them catches C++ and C allocations alike. The real implementations stay reachable
+// through their __libc_ aliases, which avoids resolving them with dlsym (which itself allocates).
+extern "C" {
+
+void *__libc_malloc(size_t);
+void *__libc_calloc(size_t, size_t);
+void *__libc_realloc(void *, size_t);
+void *__libc_memalign(size_t, size_t);
+void *__libc_valloc(size_t);
+void *__libc_pvalloc(size_t);
+void __libc_free(void *);
+
+void *malloc(size_t size)
+{
+  audio_plugin_test::recordAllocation();
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+  audio_plugin_test::recordAllocation();
+  return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+  audio_plugin_test::recordAllocation();
+  return __libc_realloc(pointer, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+  audio_plugin_test::recordAllocation();
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **result, size_t alignment, size_t size)
+{
+  audio_plugin_test::recordAllocation();
+  *result = __libc_memalign(alignment, size);
+  return *result != nullptr || size == 0 ? 0 : ENOMEM;
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+  audio_plugin_test::recordAllocation();
+  return __libc_memalign(alignment, size);
+}
+
+void *valloc(size_t size)
+{
+  audio_plugin_test::recordAllocation();
+  return __libc_valloc(size);
+}
+
+void *pvalloc(size_t size)
+{
+  audio_plugin_test::recordAllocation();
+  return __libc_pvalloc(size);
+}
+
+void free(void *pointer)
+{
+  audio_plugin_test::recordDeallocation(pointer);
+  __libc_free(pointer);
+}
+
+int pthread_mutex_lock(pthread_mutex_t *mutex)
+{
+  audio_plugin_test::recordLock();
+  return audio_plugin_test::findNext(audio_plugin_test::nextMutexLock, "pthread_mutex_lock")(mutex);
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t *lock)
+{
+  audio_plugin_test::recordLock();
+  return audio_plugin_test::findNext(audio_plugin_test::nextReadLock, "pthread_rwlock_rdlock")(lock);
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t *lock)
+{
+  audio_plugin_test::recordLock();
+  return audio_plugin_test::findNext(audio_plugin_test::nextWriteLock, "pthread_rwlock_wrlock")(lock);
+}
+
+} // extern "C"
+
+#else
+
+bool canDetectLocks()
+{
+  return false;
+}
+
+namespace {
+
+void resolveInterposedFunctions() noexcept
+{
+  // the replaced operators call straight into std::malloc, there is nothing to resolve
+}
+
+} // namespace
+
+} // namespace audio_plugin_test
+
+// Without glibc only the C++ allocation functions can be replaced portably, the over-aligned
+// variants are left alone because they need platform specific aligned deallocation.
+void *operator new(std::size_t size)
+{
+  audio_plugin_test::recordAllocation();
+  if (auto *pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+  audio_plugin_test::recordAllocation();
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept
+{
+  return operator new(size, tag);
+}
+
+void operator delete(void *pointer) noexcept
+{
+  audio_plugin_test::recordDeallocation(pointer);
+  std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+  operator delete(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+  operator delete(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+  operator delete(pointer);
+}
+
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+
+namespace audio_plugin_test {
+
+/**
+ * @brief Real-time violations observed on the current thread while a ScopedRealtimeSection was active
+*/
+struct RealtimeViolations {
+  int allocations {0};
+  int deallocations {0};
+  int locks {0};
+
+  bool any() const { return allocations + deallocations + locks > 0; }
+};
+
+/**
+ * @brief Marks the current thread as the audio thread for the lifetime of the object
+ *
+ * While the section is active, every heap allocation, heap deallocation and blocking lock taken by this
+ * thread is counted. Heap operations are detected by replacing the global allocation functions, locks by
+ * interposing the pthread lock functions, which is only possible with glibc (see canDetectLocks()).
+*/
+class ScopedRealtimeSection {
+public:
+  ScopedRealtimeSection();
+  ~ScopedRealtimeSection();
+
+  ScopedRealtimeSection(const ScopedRealtimeSection &) = delete;
+  ScopedRealtimeSection &operator=(const ScopedRealtimeSection &) = delete;
+
+  /**
+   * @brief The violations counted since the section was entered
+  */
+  RealtimeViolations getViolations() const;
+
+private:
+  bool wasActive;
+};
+
+/**
+ * @brief Whether blocking locks are detected on this platform, allocations are detected everywhere
+*/
+bool canDetectLocks();
+
+} // namespace audio_plugin_test
@@ -0,0 +1,164 @@
+#include <SimpleEQ/PluginProcessor.h>
+#include <gtest/gtest.h>
+
+#include "RealtimeSafety.h"
+
+#include <array>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace audio_plugin_test {
+
+TEST(RealtimeSafety, DetectsAllocations) {
+  RealtimeViolations violations;
+  {
+    ScopedRealtimeSection section;
+    auto *volatile pointer = new int(42);
+    delete pointer;
+    violations = section.getViolations();
+  }
+
+  EXPECT_GT(violations.allocations, 0);
+  EXPECT_GT(violations.deallocations, 0);
+}
+
+TEST(RealtimeSafety, DetectsLocks) {
+  if (!canDetectLocks()) {
+    GTEST_SKIP() << "lock detection needs glibc";
+  }
+
+  std::mutex mutex;
+  RealtimeViolations violations;
+  {
+    ScopedRealtimeSection section;
+    { std::scoped_lock lock(mutex); }
+    violations = section.getViolations();
+  }
+
+  EXPECT_GT(violations.locks, 0);
+}
+
+namespace {
+
+/**
+ * @brief Counts the notifications of every parameter, without allocating or locking
+ * JUCE takes the parameter's listener lock once per notification, which is the only lock automation may take.
+*/
+struct NotificationCounter : juce::AudioProcessorParameter::Listener {
+  explicit NotificationCounter(juce::AudioProcessor &p) : processor(p)
+  {
+    for (auto *parameter : processor.getParameters()) {
+      parameter->addListener(this);
+    }
+  }
+
+  ~NotificationCounter() override
+  {
+    for (auto *parameter : processor.getParameters()) {
+      parameter->removeListener(this);
+    }
+  }
+
+  void parameterValueChanged(int, float) override { ++count; }
+  void parameterGestureChanged(int, bool) override {}
+
+  juce::AudioProcessor &processor;
+  int count {0};
+};
+
+} // namespace
+
+/**
+ * @brief Randomly automate the parameters, switch programs and engines and process blocks, all on the audio thread
+ * like a VST3 host that delivers parameter changes inside process(), and check that nothing allocates or locks
+*/
+class ProcessBlockRealtimeSafety : public ::testing::TestWithParam<std::tuple<double, int, bool>> {};
+
+TEST_P(ProcessBlockRealtimeSafety, HasNoViolationsUnderRandomAutomation) {
+  const auto [sampleRate, maxBlockSize, smoothing] = GetParam();
+
+  audio_plugin::SimpleEQAudioProcessor processor;
+  processor.apvts.getParameter("Smoothing")->setValueNotifyingHost(smoothing ? 1.f : 0.f);
+  processor.setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+  processor.prepareToPlay(sampleRate, maxBlockSize);
+
+  // feed the analyzer like an open editor does, nothing drains it so the full FIFOs are covered as well,
+  // and keep the wake-up armed like a sleeping editor does
+  processor.getInputAnalyzerFifo().setEnabled(true);
+  processor.getOutputAnalyzerFifo().setEnabled(true);
+  processor.getEditorWakeUp().setArmed(true);
+
+  // hosts only automate what is automatable, the others change latency and are set from the message thread
+  juce::Array<juce::AudioProcessorParameter *> parameters;
+  for (auto *parameter : processor.getParameters()) {
+    if (parameter->isAutomatable()) {
+      parameters.add(parameter);
+    }
+  }
+
+  NotificationCounter notifications {processor};
+  juce::AudioBuffer<float> buffer(2, maxBlockSize);
+  juce::MidiBuffer midi;
+  juce::Random random {1234};
+
+  for (int blockIndex = 0; blockIndex < 2000; blockIndex++) {
+    const auto numSamples = 1 + random.nextInt(maxBlockSize);
+    juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), numSamples);
+    for (int ch = 0; ch < block.getNumChannels(); ch++) {
+      for (int i = 0; i < numSamples; i++) {
+        block.setSample(ch, i, random.nextFloat() * 2.f - 1.f);
+      }
+    }
+
+    // the values are drawn up front, the random generator is not what is being checked
+    std::array<std::pair<juce::AudioProcessorParameter *, float>, 3> changes {};
+    const auto numChanges = static_cast<size_t>(random.nextInt(4));
+    for (size_t i = 0; i < numChanges; i++) {
+      changes[i] = {parameters[random.nextInt(parameters.size())], random.nextFloat()};
+    }
+    const auto program = random.nextInt(50) == 0 ? random.nextInt(processor.getNumPrograms()) : -1;
+    using FilterEngine = audio_plugin::SimpleEQAudioProcessor::FilterEngine;
+    std::optional<FilterEngine> engine;
+    if (random.nextInt(100) == 0) {
+      engine = random.nextBool() ? FilterEngine::StateVariable : FilterEngine::Biquad;
+    }
+    notifications.count = 0;
+
+    RealtimeViolations violations;
+    {
+      ScopedRealtimeSection section;
+
+      // the listeners run here too, e.g. the snapshot publishes the new settings
+      for (size_t i = 0; i < numChanges; i++) {
+        changes[i].first->setValueNotifyingHost(changes[i].second);
+      }
+
+      // and now and then a program or an engine change, which the audio thread crossfades or switches to
+      if (program >= 0) {
+        processor.setCurrentProgram(program);
+      }
+      if (engine.has_value()) {
+        processor.setFilterEngine(*engine);
+      }
+
+      processor.processBlock(block, midi);
+      violations = section.getViolations();
+    }
+
+    // the parameter's own listener lock is JUCE's, every notification takes it exactly once
+    violations.locks = juce::jmax(0, violations.locks - notifications.count);
+
+    ASSERT_FALSE(violations.any()) << "block " << blockIndex << ": " 
+                                   << violations.allocations << " allocations, " 
+                                   << violations.deallocations << " deallocations, " 
+                                   << violations.locks << " locks";
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(RealtimeSafety, ProcessBlockRealtimeSafety,
+                         ::testing::Combine(::testing::Values(44100.0, 96000.0), 
+                                            ::testing::Values(32, 512), 
+                                            ::testing::Bool()));
+
+} // namespace audio_plugin_test
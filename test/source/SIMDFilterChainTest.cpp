@@ -0,0 +1,254 @@
+#include <SimpleEQ/PluginProcessor.h>
+#include <gtest/gtest.h>
+
+namespace audio_plugin_test {
+
+using namespace audio_plugin;
+
+namespace {
+
+void setReferenceChain(MonoChain &chain, const ChainSettings &settings, double sampleRate)
+{
+  updateCoefficients(chain.get<ChainPositions::Peak>().coefficients, designPeakFilter(settings, sampleRate));
+  updateCutFilters(chain.get<ChainPositions::LowCut>(), designLowCutFilter(settings, sampleRate), settings.lowCutSlope);
+  updateCutFilters(chain.get<ChainPositions::HighCut>(), designHighCutFilter(settings, sampleRate), settings.highCutSlope);
+}
+
+void setMultiChannelChain(MultiChannelChain &chain, const ChainSettings &settings, double sampleRate)
+{
+  auto peak = designPeakFilter(settings, sampleRate);
+  auto lowCut = designLowCutFilter(settings, sampleRate);
+  auto highCut = designHighCutFilter(settings, sampleRate);
+
+  chain.setStage(ChainPositions::Peak, &peak, 1);
+  chain.setStage(ChainPositions::LowCut, lowCut.data(), getNumSections(settings.lowCutSlope));
+  chain.setStage(ChainPositions::HighCut, highCut.data(), getNumSections(settings.highCutSlope));
+}
+
+} // namespace
+
+TEST(SIMDFilterChain, IsBitExactWithMonoChainPair) {
+  constexpr double sampleRate = 48000.0;
+  constexpr int maxBlockSize = 512;
+
+  ChainSettings settings;
+  settings.lowCutFreq = 120.f;
+  settings.lowCutSlope = Slope_48;
+  settings.highCutFreq = 9000.f;
+  settings.highCutSlope = Slope_24;
+  settings.peakFreq = 1000.f;
+  settings.peakGainInDecibels = 6.f;
+  settings.peakQuality = 2.f;
+
+  MonoChain left, right;
+  left.prepare({sampleRate, maxBlockSize, 1});
+  right.prepare({sampleRate, maxBlockSize, 1});
+
+  MultiChannelChain stereo;
+  stereo.prepare({sampleRate, maxBlockSize, 2});
+
+  juce::AudioBuffer<float> expected(2, maxBlockSize);
+  juce::AudioBuffer<float> actual(2, maxBlockSize);
+  juce::Random random {42};
+
+  for (int blockIndex = 0; blockIndex < 32; blockIndex++) {
+    // change the slopes halfway through so that bypassed sections have to keep their state
+    if (blockIndex == 16) {
+      settings.lowCutSlope = Slope_12;
+      settings.highCutSlope = Slope_36;
+      settings.peakGainInDecibels = -9.f;
+    }
+    if (blockIndex == 0 || blockIndex == 16) {
+      setReferenceChain(left, settings, sampleRate);
+      setReferenceChain(right, settings, sampleRate);
+      setMultiChannelChain(stereo, settings, sampleRate);
+    }
+
+    const int numSamples = maxBlockSize - blockIndex * 13;
+    for (int ch = 0; ch < 2; ch++) {
+      for (int i = 0; i < numSamples; i++) {
+        expected.setSample(ch, i, random.nextFloat() * 2.f - 1.f);
+      }
+      actual.copyFrom(ch, 0, expected, ch, 0, numSamples);
+    }
+
+    juce::dsp::AudioBlock<float> expectedBlock(expected);
+    auto expectedSubBlock = expectedBlock.getSubBlock(0, static_cast<size_t>(numSamples));
+    auto leftBlock = expectedSubBlock.getSingleChannelBlock(0);
+    auto rightBlock = expectedSubBlock.getSingleChannelBlock(1);
+    left.process(juce::dsp::ProcessContextReplacing<float>(leftBlock));
+    right.process(juce::dsp::ProcessContextReplacing<float>(rightBlock));
+
+    juce::dsp::AudioBlock<float> actualBlock(actual);
+    auto actualSubBlock = actualBlock.getSubBlock(0, static_cast<size_t>(numSamples));
+    stereo.process(juce::dsp::ProcessContextReplacing<float>(actualSubBlock));
+
+    for (int ch = 0; ch < 2; ch++) {
+      for (int i = 0; i < numSamples; i++) {
+        ASSERT_EQ(expected.getSample(ch, i), actual.getSample(ch, i)) << "block " << blockIndex << ", channel " << ch << ", sample " << i;
+      }
+    }
+  }
+}
+
+TEST(SIMDFilterChain, PipelinedMonoIsBitExactWithMonoChain) {
+  constexpr double sampleRate = 44100.0;
+  constexpr int maxBlockSize = 256;
+
+  ChainSettings settings;
+  settings.lowCutFreq = 60.f;
+  settings.highCutFreq = 11000.f;
+  settings.peakFreq = 3000.f;
+  settings.peakGainInDecibels = -5.f;
+  settings.peakQuality = 1.2f;
+
+  for (int slope = Slope_12; slope <= Slope_48; slope++) {
+    settings.lowCutSlope = static_cast<Slope>(slope);
+    settings.highCutSlope = static_cast<Slope>(slope);
+
+    MonoChain reference;
+    reference.prepare({sampleRate, maxBlockSize, 1});
+    setReferenceChain(reference, settings, sampleRate);
+
+    MultiChannelChain mono;
+    mono.prepare({sampleRate, maxBlockSize, 1});
+    setMultiChannelChain(mono, settings, sampleRate);
+
+    juce::AudioBuffer<float> expected(1, maxBlockSize);
+    juce::AudioBuffer<float> actual(1, maxBlockSize);
+    juce::Random random {slope + 11};
+
+    for (int blockIndex = 0; blockIndex < 24; blockIndex++) {
+      // the peak moves halfway through, the pipeline must pick up the new coefficients and keep the state
+      if (blockIndex == 12) {
+        auto changed = settings;
+        changed.peakFreq = 400.f;
+        changed.peakGainInDecibels = 8.f;
+        setReferenceChain(reference, changed, sampleRate);
+        setMultiChannelChain(mono, changed, sampleRate);
+      }
+
+      // blocks shorter than the pipeline is deep never reach the vectorized part
+      const int numSamples = blockIndex % 4 == 0 ? blockIndex / 4 + 1 : random.nextInt(maxBlockSize) + 1;
+      for (int i = 0; i < numSamples; i++) {
+        expected.setSample(0, i, random.nextFloat() * 2.f - 1.f);
+      }
+      actual.copyFrom(0, 0, expected, 0, 0, numSamples);
+
+      juce::dsp::AudioBlock<float> expectedBlock(expected), actualBlock(actual);
+      auto expectedSubBlock = expectedBlock.getSubBlock(0, static_cast<size_t>(numSamples));
+      auto actualSubBlock = actualBlock.getSubBlock(0, static_cast<size_t>(numSamples));
+      reference.process(juce::dsp::ProcessContextReplacing<float>(expectedSubBlock));
+      mono.process(juce::dsp::ProcessContextReplacing<float>(actualSubBlock));
+
+      for (int i = 0; i < numSamples; i++) {
+        ASSERT_EQ(expected.getSample(0, i), actual.getSample(0, i)) << "slope " << slope << ", block " << blockIndex << ", sample " << i;
+      }
+    }
+  }
+}
+
+TEST(SIMDFilterChain, ProcessesEveryChannelOfWideLayouts) {
+  constexpr double sampleRate = 96000.0;
+  constexpr int blockSize = 128;
+
+  ChainSettings settings;
+  settings.lowCutFreq = 40.f;
+  settings.lowCutSlope = Slope_36;
+  settings.highCutFreq = 15000.f;
+  settings.highCutSlope = Slope_12;
+  settings.peakFreq = 250.f;
+  settings.peakGainInDecibels = -4.5f;
+  settings.peakQuality = 0.7f;
+
+  // one channel more than a group of lanes leaves a partly filled group, whose unused lanes must not leak into the channels
+  constexpr auto lanes = numLanes<float>();
+  if constexpr (lanes == 1) {
+    GTEST_SKIP() << "without SIMD every group of lanes is full";
+  }
+  const auto numChannels = static_cast<int>(lanes + 1);
+
+  MultiChannelChain chain;
+  chain.prepare({sampleRate, blockSize, static_cast<juce::uint32>(numChannels)});
+  setMultiChannelChain(chain, settings, sampleRate);
+
+  juce::AudioBuffer<float> expected(numChannels, blockSize);
+  juce::Random random {7};
+  for (int ch = 0; ch < numChannels; ch++) {
+    for (int i = 0; i < blockSize; i++) {
+      expected.setSample(ch, i, random.nextFloat() * 2.f - 1.f);
+    }
+  }
+
+  juce::AudioBuffer<float> actual(expected);
+  juce::dsp::AudioBlock<float> actualBlock(actual);
+  chain.process(juce::dsp::ProcessContextReplacing<float>(actualBlock));
+
+  juce::dsp::AudioBlock<float> expectedBlock(expected);
+  for (int ch = 0; ch < numChannels; ch++) {
+    MonoChain reference;
+    reference.prepare({sampleRate, blockSize, 1});
+    setReferenceChain(reference, settings, sampleRate);
+
+    auto channelBlock = expectedBlock.getSingleChannelBlock(static_cast<size_t>(ch));
+    reference.process(juce::dsp::ProcessContextReplacing<float>(channelBlock));
+
+    for (int i = 0; i < blockSize; i++) {
+      ASSERT_EQ(expected.getSample(ch, i), actual.getSample(ch, i)) << "channel " << ch << ", sample " << i;
+    }
+  }
+}
+
+TEST(SIMDFilterChain, SkipsFlatAndUnusedBands) {
+  constexpr double sampleRate = 48000.0;
+  constexpr int blockSize = 256;
+
+  MultiChannelChain chain;
+  chain.prepare({sampleRate, blockSize, 2});
+
+  BandSettings band;
+  band.type = BandType::Peak;
+  band.freq = 2000.f;
+  band.gainInDecibels = 0.f;
+
+  for (size_t i = 0; i < numExtraBands; i++) {
+    auto coefficients = designBand(band, sampleRate);
+    chain.setStage(getBandPosition(i), &coefficients, getNumSections(band));
+  }
+  EXPECT_EQ(chain.getNumActiveSections(), 0u);
+
+  juce::AudioBuffer<float> buffer(2, blockSize);
+  juce::Random random {7};
+  for (int ch = 0; ch < 2; ch++) {
+    for (int i = 0; i < blockSize; i++) {
+      buffer.setSample(ch, i, random.nextFloat() * 2.f - 1.f);
+    }
+  }
+  juce::AudioBuffer<float> input(buffer);
+
+  juce::dsp::AudioBlock<float> block(buffer);
+  chain.process(juce::dsp::ProcessContextReplacing<float>(block));
+
+  for (int ch = 0; ch < 2; ch++) {
+    for (int i = 0; i < blockSize; i++) {
+      ASSERT_EQ(buffer.getSample(ch, i), input.getSample(ch, i));
+    }
+  }
+
+  // a band that is switched on only costs its own section
+  band.gainInDecibels = 6.f;
+  auto boost = designBand(band, sampleRate);
+  chain.setStage(getBandPosition(4), &boost, getNumSections(band));
+  EXPECT_EQ(chain.getNumActiveSections(), 1u);
+
+  // ramping back to 0 dB drops the band once the ramp is done
+  band.gainInDecibels = 0.f;
+  auto flat = designBand(band, sampleRate);
+  chain.setStage(getBandPosition(4), &flat, getNumSections(band), 64);
+  EXPECT_EQ(chain.getNumActiveSections(), 1u);
+
+  chain.process(juce::dsp::ProcessContextReplacing<float>(block));
+  EXPECT_EQ(chain.getNumActiveSections(), 0u);
+}
+
+} // namespace audio_plugin_test
@@ -0,0 +1,165 @@
+#include <SimpleEQ/PluginProcessor.h>
+#include <gtest/gtest.h>
+
+namespace audio_plugin_test {
+
+using namespace audio_plugin;
+
+namespace {
+
+void setBiquadChain(DoubleMultiChannelChain &chain, const ChainSettings &settings, double sampleRate)
+{
+  auto peak = designPeakFilter<double>(settings, sampleRate);
+  auto lowCut = designLowCutFilter<double>(settings, sampleRate);
+  auto highCut = designHighCutFilter<double>(settings, sampleRate);
+
+  chain.setStage(ChainPositions::Peak, &peak, 1);
+  chain.setStage(ChainPositions::LowCut, lowCut.data(), getNumSections(settings.lowCutSlope));
+  chain.setStage(ChainPositions::HighCut, highCut.data(), getNumSections(settings.highCutSlope));
+
+  for (size_t i = 0; i < numExtraBands; i++) {
+    auto band = designBand<double>(settings.bands[i], sampleRate);
+    chain.setStage(getBandPosition(i), &band, getNumSections(settings.bands[i]));
+  }
+}
+
+void fillWithNoise(juce::AudioBuffer<double> &buffer, juce::int64 seed)
+{
+  juce::Random random {seed};
+  for (int ch = 0; ch < buffer.getNumChannels(); ch++) {
+    for (int i = 0; i < buffer.getNumSamples(); i++) {
+      buffer.setSample(ch, i, random.nextDouble() * 2.0 - 1.0);
+    }
+  }
+}
+
+} // namespace
+
+TEST(SVFFilterChain, MatchesTheBiquadChain) {
+  constexpr double sampleRate = 48000.0;
+  constexpr int numSamples = 4096;
+
+  ChainSettings settings;
+  settings.lowCutFreq = 40.f;
+  settings.highCutFreq = 15000.f;
+  settings.peakFreq = 1200.f;
+  settings.peakGainInDecibels = -7.5f;
+  settings.peakQuality = 3.f;
+
+  // one extra band of every type
+  const std::array<BandType, 6> types {BandType::Peak, BandType::LowShelf, BandType::HighShelf,
+                                       BandType::Notch, BandType::LowCut, BandType::HighCut};
+  for (size_t i = 0; i < types.size(); i++) {
+    settings.bands[i] = {types[i], 150.f * static_cast<float>(i + 1), 4.5f, 0.7f + 0.3f * static_cast<float>(i)};
+  }
+
+  for (int slope = Slope_12; slope <= Slope_48; slope++) {
+    settings.lowCutSlope = static_cast<Slope>(slope);
+    settings.highCutSlope = static_cast<Slope>(Slope_48 - slope);
+
+    DoubleMultiChannelChain biquads;
+    DoubleStateVariableChain stateVariable;
+    biquads.prepare({sampleRate, numSamples, 2});
+    stateVariable.prepare({sampleRate, numSamples, 2});
+    setBiquadChain(biquads, settings, sampleRate);
+    setStateVariableChain(stateVariable, settings, sampleRate);
+
+    juce::AudioBuffer<double> expected(2, numSamples);
+    fillWithNoise(expected, slope + 1);
+    juce::AudioBuffer<double> actual(expected);
+
+    juce::dsp::AudioBlock<double> expectedBlock(expected), actualBlock(actual);
+    biquads.process(juce::dsp::ProcessContextReplacing<double>(expectedBlock));
+    stateVariable.process(juce::dsp::ProcessContextReplacing<double>(actualBlock));
+
+    for (int ch = 0; ch < 2; ch++) {
+      for (int i = 0; i < numSamples; i++) {
+        ASSERT_NEAR(actual.getSample(ch, i), expected.getSample(ch, i), 1.0e-7) << "slope " << slope << ", sample " << i;
+      }
+    }
+  }
+}
+
+TEST(SVFFilterChain, RampsEndOnTheTarget) {
+  constexpr double sampleRate = 48000.0;
+  constexpr int numSamples = 48000;
+  constexpr size_t rampLength = 300;
+
+  ChainSettings from, to;
+  from.lowCutFreq = 30.f;
+  from.highCutFreq = 18000.f;
+  from.peakFreq = 200.f;
+  from.peakGainInDecibels = -12.f;
+  from.peakQuality = 0.5f;
+  to = from;
+  to.lowCutFreq = 400.f;
+  to.highCutFreq = 2500.f;
+  to.peakFreq = 6000.f;
+  to.peakGainInDecibels = 9.f;
+  to.peakQuality = 4.f;
+
+  DoubleStateVariableChain ramped, direct;
+  ramped.prepare({sampleRate, numSamples, 1});
+  direct.prepare({sampleRate, numSamples, 1});
+  setStateVariableChain(ramped, from, sampleRate);
+  setStateVariableChain(ramped, to, sampleRate, rampLength);
+  setStateVariableChain(direct, to, sampleRate);
+
+  juce::AudioBuffer<double> expected(1, numSamples);
+  fillWithNoise(expected, 3);
+  juce::AudioBuffer<double> actual(expected);
+
+  // the ramp is split across two blocks, once its transient has decayed both chains have to respond alike
+  juce::dsp::AudioBlock<double> expectedBlock(expected), actualBlock(actual);
+  auto firstHalf = actualBlock.getSubBlock(0, rampLength / 2);
+  auto rest = actualBlock.getSubBlock(rampLength / 2);
+  ramped.process(juce::dsp::ProcessContextReplacing<double>(firstHalf));
+  ramped.process(juce::dsp::ProcessContextReplacing<double>(rest));
+  direct.process(juce::dsp::ProcessContextReplacing<double>(expectedBlock));
+
+  for (int i = numSamples - 1024; i < numSamples; i++) {
+    ASSERT_NEAR(actual.getSample(0, i), expected.getSample(0, i), 1.0e-9);
+  }
+}
+
+TEST(SVFFilterChain, ProcessorEnginesAgree) {
+  constexpr double sampleRate = 44100.0;
+  constexpr int blockSize = 256;
+
+  SimpleEQAudioProcessor biquadProcessor{}, stateVariableProcessor{};
+  stateVariableProcessor.setFilterEngine(SimpleEQAudioProcessor::FilterEngine::StateVariable);
+
+  for (auto *processor : {&biquadProcessor, &stateVariableProcessor}) {
+    processor->apvts.getParameter("Peak Gain")->setValueNotifyingHost(0.8f);
+    processor->apvts.getParameter("LowCut Freq")->setValueNotifyingHost(0.3f);
+    processor->apvts.getParameter("LowCut Slope")->setValueNotifyingHost(1.f);
+    processor->apvts.getParameter("HighCut Freq")->setValueNotifyingHost(0.8f);
+    processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor->prepareToPlay(sampleRate, blockSize);
+  }
+
+  juce::AudioBuffer<float> biquadBuffer(2, blockSize), stateVariableBuffer(2, blockSize);
+  juce::MidiBuffer midi;
+  juce::Random random {5};
+
+  for (int block = 0; block < 8; block++) {
+    for (int ch = 0; ch < 2; ch++) {
+      for (int i = 0; i < blockSize; i++) {
+        const auto sample = random.nextFloat() * 2.f - 1.f;
+        biquadBuffer.setSample(ch, i, sample);
+        stateVariableBuffer.setSample(ch, i, sample);
+      }
+    }
+
+    biquadProcessor.processBlock(biquadBuffer, midi);
+    stateVariableProcessor.processBlock(stateVariableBuffer, midi);
+
+    for (int ch = 0; ch < 2; ch++) {
+      for (int i = 0; i < blockSize; i++) {
+        ASSERT_NEAR(stateVariableBuffer.getSample(ch, i), biquadBuffer.getSample(ch, i), 1.0e-4);
+      }
+    }
+  }
+}
+
+} // namespace audio_plugin_test